@@ -0,0 +1,357 @@
+#ifndef FUDGE_ALL_PAIRS_TABLE_H_
+#define FUDGE_ALL_PAIRS_TABLE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util/log.h"
+#include "grid_dijkstra.h"
+
+// This implements a table of the shortest distances between every pair of
+// passable nodes of a small grid map (up to about 128x128). It is built once
+// by running a Dijkstra search from every passable node in parallel. Each
+// distance is quantized into 16 bits, rounded down so that the table is an
+// admissible heuristic. Only passable nodes are indexed, so the table takes
+// 2 bytes for each pair of passable nodes.
+
+namespace fudge {
+
+template <typename CostType = double>
+class AllPairsTable {
+public:
+  AllPairsTable() = default;
+  virtual ~AllPairsTable() = default;
+
+public:
+  static constexpr uint16_t kUnreachable = 0xFFFF;
+  static constexpr uint16_t kMaxQuantized = 0xFFFE;
+
+public:
+  // Build the table with edges of a GridMap with the same matrix. If threads
+  // is 0, the number of hardware threads is used.
+  void build(const VertexMatrix<CostType> &vertex_matrix,
+             bool enable_diagonal = true, unsigned int threads = 0) {
+    w_ = vertex_matrix.width_;
+    h_ = vertex_matrix.height_;
+    enable_diagonal_ = enable_diagonal;
+    index_cells(vertex_matrix);
+    resolution_ = resolution_of(vertex_matrix);
+
+    const std::size_t n = cells_.size();
+    data_.assign(n * n, kUnreachable);
+
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+      workers.push_back(std::thread([&]() {
+        std::vector<CostType> dist;
+        std::size_t i;
+        while ((i = next++) < n) {
+          grid_dijkstra(vertex_matrix, cells_[i], enable_diagonal_, dist);
+          uint16_t *row = &data_[i * n];
+          for (std::size_t j = 0; j < n; j++)
+            row[j] = quantize(dist[cell_index(cells_[j])]);
+        }
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  // Return the distance, or -1 if the goal is unreachable.
+  CostType distance(const Coord &from, const Coord &to) const {
+    uint16_t q = quantized(from, to);
+    if (q == kUnreachable)
+      return static_cast<CostType>(-1);
+    return static_cast<CostType>(q * resolution_);
+  }
+
+  bool is_reachable(const Coord &from, const Coord &to) const {
+    return quantized(from, to) != kUnreachable;
+  }
+
+  // Walk from start to goal by moving to the neighbor on a shortest path at
+  // each step. The path is returned in the same order as GridMap::get_path():
+  // from the goal back to the node next to the start. If the walk doesn't
+  // reach the goal, as on a corrupt table, no path is returned.
+  std::vector<Coord> path(const Coord &start, const Coord &goal) const {
+    std::vector<Coord> result;
+    if (!is_reachable(start, goal))
+      return result;
+
+    Coord c = start;
+    while (c != goal && result.size() < cells_.size()) {
+      Coord best = c;
+      double best_cost = 0;
+      for (int k = 0; k < 8; k++) {
+        if (!enable_diagonal_ && kNeighborX[k] != 0 && kNeighborY[k] != 0)
+          continue;
+        const Coord n(c.first + kNeighborX[k], c.second + kNeighborY[k]);
+        if (!is_passable(n) || !is_reachable(n, goal))
+          continue;
+
+        double cost = neighbor_edge_weight<double>(k) * weights_[cell_of(n)]
+            + quantized(n, goal) * resolution_;
+        if (best == c || cost < best_cost) {
+          best = n;
+          best_cost = cost;
+        }
+      }
+      c = best;
+      result.push_back(c);
+    }
+    if (c != goal) {
+      ERROR("Distance table walk from (%d, %d) missed (%d, %d).",
+            start.first, start.second, goal.first, goal.second);
+      return std::vector<Coord>();
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+  }
+
+  // Bytes used by the distances.
+  std::size_t bytes() const {
+    return data_.size() * sizeof(uint16_t);
+  }
+
+  int width() const {
+    return w_;
+  }
+
+  int height() const {
+    return h_;
+  }
+
+  double resolution() const {
+    return resolution_;
+  }
+
+public:
+  // Save the table to a binary file.
+  bool save(const std::string &filename) const {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open()) {
+      ERROR("Failed to open %s for writing.", filename.c_str());
+      return false;
+    }
+
+    const uint32_t n = cells_.size();
+    const uint8_t diagonal = enable_diagonal_ ? 1 : 0;
+    ofs.write(kMagic, sizeof(kMagic));
+    write(ofs, kVersion);
+    write(ofs, w_);
+    write(ofs, h_);
+    write(ofs, diagonal);
+    write(ofs, resolution_);
+    write(ofs, n);
+    ofs.write(reinterpret_cast<const char *>(cell_of_.data()),
+              cell_of_.size() * sizeof(int32_t));
+    ofs.write(reinterpret_cast<const char *>(weights_.data()),
+              weights_.size() * sizeof(double));
+    ofs.write(reinterpret_cast<const char *>(data_.data()),
+              data_.size() * sizeof(uint16_t));
+    return ofs.good();
+  }
+
+  // Load a table saved by save(). Return false if the file is invalid.
+  bool load(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+      ERROR("File not found: %s", filename.c_str());
+      return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t n = 0;
+    uint8_t diagonal = 0;
+    ifs.read(magic, sizeof(magic));
+    read(ifs, version);
+    if (!ifs.good() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0
+        || version != kVersion) {
+      ERROR("Invalid distance table: %s", filename.c_str());
+      return false;
+    }
+
+    read(ifs, w_);
+    read(ifs, h_);
+    read(ifs, diagonal);
+    read(ifs, resolution_);
+    read(ifs, n);
+    if (!ifs.good() || w_ <= 0 || h_ <= 0
+        || n > static_cast<uint32_t>(w_ * h_)) {
+      ERROR("Invalid distance table header: %s", filename.c_str());
+      return false;
+    }
+    enable_diagonal_ = diagonal != 0;
+
+    cell_of_.resize(w_ * h_);
+    weights_.resize(n);
+    data_.resize(static_cast<std::size_t>(n) * n);
+    ifs.read(reinterpret_cast<char *>(cell_of_.data()),
+             cell_of_.size() * sizeof(int32_t));
+    ifs.read(reinterpret_cast<char *>(weights_.data()),
+             weights_.size() * sizeof(double));
+    ifs.read(reinterpret_cast<char *>(data_.data()),
+             data_.size() * sizeof(uint16_t));
+    if (!ifs.good()) {
+      ERROR("Truncated distance table: %s", filename.c_str());
+      return false;
+    }
+
+    cells_.assign(n, Coord(-1, -1));
+    for (int i = 0; i < w_ * h_; i++) {
+      if (cell_of_[i] >= static_cast<int32_t>(n)) {
+        ERROR("Invalid distance table index: %s", filename.c_str());
+        return false;
+      }
+      if (cell_of_[i] >= 0)
+        cells_[cell_of_[i]] = Coord(i % w_, i / w_);
+    }
+    return true;
+  }
+
+private:
+  static constexpr char kMagic[8] {'F', 'U', 'D', 'G', 'E', 'A', 'P', 'T'};
+  static constexpr uint32_t kVersion = 1;
+
+  int32_t w_ = 0;
+  int32_t h_ = 0;
+  bool enable_diagonal_ = true;
+  double resolution_ = 1;          // Distance of each quantized unit.
+  std::vector<Coord> cells_;       // Passable nodes by index.
+  std::vector<int32_t> cell_of_;   // Index of each node, or -1.
+  std::vector<double> weights_;    // Weight of each passable node.
+  std::vector<uint16_t> data_;     // Row of distances for each source.
+
+private:
+  int cell_index(const Coord &c) const {
+    return c.second * w_ + c.first;
+  }
+
+  int cell_of(const Coord &c) const {
+    return cell_of_[cell_index(c)];
+  }
+
+  bool is_passable(const Coord &c) const {
+    return c.first >= 0 && c.first < w_ && c.second >= 0 && c.second < h_
+        && cell_of(c) >= 0;
+  }
+
+  uint16_t quantized(const Coord &from, const Coord &to) const {
+    if (!is_passable(from) || !is_passable(to))
+      return kUnreachable;
+    return data_[static_cast<std::size_t>(cell_of(from)) * cells_.size()
+                 + cell_of(to)];
+  }
+
+  // Round down so that the distance is never overestimated.
+  uint16_t quantize(CostType d) const {
+    if (d < 0)
+      return kUnreachable;
+    double q = std::floor(d / resolution_ + 1e-9);
+    return static_cast<uint16_t>(std::min<double>(q, kMaxQuantized));
+  }
+
+  void index_cells(const VertexMatrix<CostType> &vertex_matrix) {
+    cells_.clear();
+    weights_.clear();
+    cell_of_.assign(w_ * h_, -1);
+    for (int y = 0; y < h_; y++) {
+      for (int x = 0; x < w_; x++) {
+        if (vertex_matrix.is_passable(Coord(x, y))) {
+          cell_of_[cell_index(Coord(x, y))] = cells_.size();
+          cells_.push_back(Coord(x, y));
+          weights_.push_back(vertex_matrix.weight(Coord(x, y)));
+        }
+      }
+    }
+  }
+
+  // Bound the longest distance by the distances to and from one node of each
+  // connected area: d(a, b) <= d(a, r) + d(r, b). Integer distances are kept
+  // exact if they fit.
+  double resolution_of(const VertexMatrix<CostType> &vertex_matrix) const {
+    std::vector<bool> covered(w_ * h_, false);
+    std::vector<CostType> from;
+    std::vector<CostType> to;
+    double bound = 0;
+    for (const Coord &c : cells_) {
+      if (covered[cell_index(c)])
+        continue;
+
+      grid_dijkstra(vertex_matrix, c, enable_diagonal_, from);
+      grid_dijkstra(vertex_matrix, c, enable_diagonal_, to, nullptr, true);
+      CostType max_from = 0;
+      CostType max_to = 0;
+      for (int i = 0; i < w_ * h_; i++) {
+        if (from[i] >= 0) {
+          covered[i] = true;
+          max_from = std::max(max_from, from[i]);
+          max_to = std::max(max_to, to[i]);
+        }
+      }
+      bound = std::max(bound, static_cast<double>(max_from + max_to));
+    }
+
+    if (std::numeric_limits<CostType>::is_integer && bound <= kMaxQuantized)
+      return 1;
+    return std::max(bound, 1.0) / kMaxQuantized;
+  }
+
+  template <typename T>
+  static void write(std::ofstream &ofs, const T &v) {
+    ofs.write(reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template <typename T>
+  static void read(std::ifstream &ifs, T &v) {
+    ifs.read(reinterpret_cast<char *>(&v), sizeof(T));
+  }
+};
+
+template <typename CostType>
+constexpr char AllPairsTable<CostType>::kMagic[8];
+
+template <typename CostType>
+constexpr uint32_t AllPairsTable<CostType>::kVersion;
+
+template <typename CostType>
+constexpr uint16_t AllPairsTable<CostType>::kUnreachable;
+
+template <typename CostType>
+constexpr uint16_t AllPairsTable<CostType>::kMaxQuantized;
+
+// Heuristic to plug the table into astar_search(). It is cheap to copy.
+template <typename CostType = double>
+class AllPairsHeuristic {
+public:
+  explicit AllPairsHeuristic(const AllPairsTable<CostType> &table)
+    : table_(&table) {};
+
+public:
+  CostType operator ()(const Coord &n0, const Coord &n1) const {
+    CostType d = table_->distance(n0, n1);
+    if (d < 0) // Unreachable. Keep the node at the end of open list.
+      return std::numeric_limits<CostType>::max() / 4;
+    return d;
+  }
+
+private:
+  const AllPairsTable<CostType> *table_;
+};
+
+}
+
+#endif /* FUDGE_ALL_PAIRS_TABLE_H_ */
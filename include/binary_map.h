@@ -0,0 +1,168 @@
+#ifndef FUDGE_BINARY_MAP_H_
+#define FUDGE_BINARY_MAP_H_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "util/log.h"
+#include "util/mapped_file.h"
+#include "vertex_matrix.h"
+
+// This implements a versioned binary format of weight matrices. A 64 bytes
+// header is followed by the raw weights in row-major order, in the byte order
+// of the host. Since the payload starts at an aligned offset, a memory mapped
+// file could be used as a VertexMatrix in place without copying, and the
+// pages are shared by all processes loading the same map.
+
+namespace fudge {
+
+// Type codes of weights stored in the header.
+template <typename WeightType> struct BinaryMapType;
+template <> struct BinaryMapType<int8_t>   { enum { code = 1 }; };
+template <> struct BinaryMapType<uint8_t>  { enum { code = 2 }; };
+template <> struct BinaryMapType<int16_t>  { enum { code = 3 }; };
+template <> struct BinaryMapType<uint16_t> { enum { code = 4 }; };
+template <> struct BinaryMapType<int32_t>  { enum { code = 5 }; };
+template <> struct BinaryMapType<uint32_t> { enum { code = 6 }; };
+template <> struct BinaryMapType<float>    { enum { code = 7 }; };
+template <> struct BinaryMapType<double>   { enum { code = 8 }; };
+
+struct BinaryMapHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  int32_t width;
+  int32_t height;
+  uint32_t weight_type;
+  uint32_t weight_size;
+  uint64_t payload_offset;
+  uint64_t payload_size;
+  uint64_t checksum;       // FNV-1a of the payload.
+  uint8_t reserved[8];
+};
+
+static_assert(sizeof(BinaryMapHeader) == 64, "Unexpected header size.");
+
+static constexpr char kBinaryMapMagic[8] {'F','U','D','G','E','M','A','P'};
+static constexpr uint32_t kBinaryMapVersion = 1;
+
+// 64-bit FNV-1a hash.
+inline uint64_t fnv1a(const void *data, std::size_t size) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  uint64_t h = 14695981039346656037ULL;
+  for (std::size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Write a matrix to a binary map file.
+template <typename WeightType>
+bool write_binary_map(const std::string &filename, int width, int height,
+                      const std::vector<WeightType> &matrix) {
+  if (matrix.size() != static_cast<std::size_t>(width) * height) {
+    ERROR("Matrix size %zu does not match %dx%d.", matrix.size(), width,
+          height);
+    return false;
+  }
+
+  BinaryMapHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kBinaryMapMagic, sizeof(header.magic));
+  header.version = kBinaryMapVersion;
+  header.header_size = sizeof(header);
+  header.width = width;
+  header.height = height;
+  header.weight_type = BinaryMapType<WeightType>::code;
+  header.weight_size = sizeof(WeightType);
+  header.payload_offset = sizeof(header);
+  header.payload_size = matrix.size() * sizeof(WeightType);
+  header.checksum = fnv1a(matrix.data(), header.payload_size);
+
+  std::ofstream ofs(filename, std::ios::binary);
+  if (!ofs.is_open()) {
+    ERROR("Failed to open %s for writing.", filename.c_str());
+    return false;
+  }
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<const char *>(matrix.data()),
+            header.payload_size);
+  return ofs.good();
+}
+
+// A weight matrix read from a memory mapped binary map file. The weights are
+// not copied. The header is validated when the file is opened. Call verify()
+// to check the payload against the checksum, which reads the whole file.
+template <typename WeightType>
+class MappedMatrix {
+public:
+  explicit MappedMatrix(const std::string &filename) : file_(filename) {
+    if (!file_.is_open()) {
+      ERROR("File not found: %s", filename.c_str());
+      return;
+    }
+
+    if (file_.size() < sizeof(BinaryMapHeader)) {
+      ERROR("Invalid binary map: %s", filename.c_str());
+      return;
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+
+    if (std::memcmp(header_.magic, kBinaryMapMagic, sizeof(header_.magic))
+        != 0 || header_.version != kBinaryMapVersion) {
+      ERROR("Invalid binary map: %s", filename.c_str());
+    } else if (header_.weight_type != BinaryMapType<WeightType>::code
+        || header_.weight_size != sizeof(WeightType)) {
+      ERROR("Unexpected weight type %u in %s.", header_.weight_type,
+            filename.c_str());
+    } else if (header_.width < 0 || header_.height < 0
+        || header_.payload_size != static_cast<uint64_t>(header_.width)
+            * header_.height * sizeof(WeightType)
+        || header_.payload_offset % alignof(WeightType) != 0
+        || header_.payload_offset + header_.payload_size > file_.size()) {
+      ERROR("Truncated binary map: %s", filename.c_str());
+    } else {
+      data_ = reinterpret_cast<const WeightType *>(
+          file_.data() + header_.payload_offset);
+    }
+  }
+
+public:
+  bool is_open() const {
+    return data_ != nullptr;
+  }
+
+  int width() const {
+    return header_.width;
+  }
+
+  int height() const {
+    return header_.height;
+  }
+
+  const WeightType *data() const {
+    return data_;
+  }
+
+  // Return a matrix pointing to the mapped weights. It should not outlive
+  // this instance.
+  VertexMatrix<WeightType> vertex_matrix() const {
+    return VertexMatrix<WeightType>(header_.width, header_.height, data_);
+  }
+
+  bool verify() const {
+    return is_open() && fnv1a(data_, header_.payload_size) == header_.checksum;
+  }
+
+private:
+  MappedFile file_;
+  BinaryMapHeader header_ {};
+  const WeightType *data_ = nullptr;
+};
+
+}
+
+#endif /* FUDGE_BINARY_MAP_H_ */
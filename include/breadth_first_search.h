@@ -0,0 +1,295 @@
+#ifndef FUDGE_BREADTH_FIRST_SEARCH_H_
+#define FUDGE_BREADTH_FIRST_SEARCH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "flat_hash_map.h"
+#include "node_state.h"
+
+// Breadth first searches for position maps whose edges all cost the same,
+// where a FIFO queue takes the place of the open list of A*.
+//
+// search() keeps explored nodes in the storage of the map as astar_search
+// does, so the path and stats of the map are used as usual.
+//
+// bidirectional_search() searches from both ends, a layer at a time from the
+// end with the smaller frontier, and visits far fewer nodes. Every edge should
+// be reversible, as edges of a node are taken as its incoming edges too.
+//
+// frontier_search() keeps only the last three layers, as neighbors of a node
+// are in the layer before, the same layer or the layer after if edges are
+// reversible. Then the path is rebuilt by divide and conquer: the node of the
+// middle layer on the path is found by searching again, carrying middle
+// nodes along, and each half is solved the same way. Memory is that of the
+// widest three layers, for about twice the time. With edges not reversible,
+// nodes of older layers are visited again, which may go on forever when the
+// goal can't be reached. The path found is still shortest, and a search is
+// given up once a pair of layers repeats, as layers would repeat from then on.
+//
+// Paths are returned from the goal back to the start, as astar_search.
+
+namespace fudge {
+
+template <typename MapType>
+class BreadthFirstSearch {
+public:
+  using NodeType = typename MapType::Node;
+  using HashType = typename MapType::Hash;
+
+public:
+  explicit BreadthFirstSearch(MapType &map) : map_(map) {};
+  virtual ~BreadthFirstSearch() = default;
+
+public:
+  std::vector<NodeType> search(const NodeType &start, const NodeType &goal) {
+    reset();
+    std::deque<NodeType> open;
+    visit(map_.map_, start, start, 0);
+    open.push_back(start);
+
+    while (!open.empty()) {
+      const NodeType n = open.front();
+      open.pop_front();
+      NodeType &nn = map_.map_.at(n.hash());
+      nn.state_ = NodeState::closed;
+      map_.stats_.nodes_closed++;
+      nodes_expanded_++;
+      if (n.hash() == goal.hash())
+        return map_.get_path(nn);
+
+      const int g = nn.g_;
+      for (const auto &edge : map_.edges(n)) {
+        if (map_.map_.count(edge.to_.hash()) == 0) {
+          visit(map_.map_, edge.to_, n, g + 1);
+          open.push_back(edge.to_);
+        }
+      }
+      nodes_held_ = std::max(nodes_held_, map_.map_.size());
+    }
+    return std::vector<NodeType>(); // No path found.
+  }
+
+  std::vector<NodeType> bidirectional_search(const NodeType &start,
+                                             const NodeType &goal) {
+    reset();
+    Storage backward;
+    std::vector<NodeType> forward_layer {start};
+    std::vector<NodeType> backward_layer {goal};
+    visit(map_.map_, start, start, 0);
+    visit(backward, goal, goal, 0);
+
+    bool found = start.hash() == goal.hash();
+    NodeType meet = start;
+    while (!found && !forward_layer.empty() && !backward_layer.empty()) {
+      // Of the nodes met in a layer, the one of the least depth on the other
+      // side gives the shortest path.
+      int best = -1;
+      if (forward_layer.size() <= backward_layer.size())
+        best = expand_layer(map_.map_, backward, forward_layer, meet);
+      else
+        best = expand_layer(backward, map_.map_, backward_layer, meet);
+      found = best >= 0;
+      nodes_held_ = std::max(nodes_held_,
+                             map_.map_.size() + backward.size());
+    }
+    if (!found)
+      return std::vector<NodeType>();
+
+    // Join the half from the meeting node back to the start, and the half
+    // from it to the goal.
+    std::vector<NodeType> path;
+    NodeType p = backward.at(meet.hash());
+    while (p.parent_ != p.hash()) {
+      p = backward.at(p.parent_);
+      path.push_back(p);
+    }
+    std::reverse(path.begin(), path.end());
+    const std::vector<NodeType> half = map_.get_path(map_.map_.at(meet.hash()));
+    path.insert(path.end(), half.begin(), half.end());
+    return path;
+  }
+
+  std::vector<NodeType> frontier_search(const NodeType &start,
+                                        const NodeType &goal) {
+    reset();
+    NodeType middle;
+    const int depth = search_layers(start, goal, -1, middle);
+    if (depth < 0)
+      return std::vector<NodeType>();
+
+    std::vector<NodeType> path {start};
+    solve(start, goal, depth, path);
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  // Nodes expanded, over all searches of the last call.
+  std::size_t nodes_expanded() const {
+    return nodes_expanded_;
+  }
+
+  // Most nodes held at once by the last call.
+  std::size_t nodes_held() const {
+    return nodes_held_;
+  }
+
+private:
+  using Storage = decltype(MapType::map_);
+
+  // A layer of the frontier search, with the index of the middle node each
+  // node is reached from, or kNoRelay above the middle layer.
+  struct Layer {
+    std::vector<NodeType> nodes;
+    FlatHashMap<HashType, uint32_t> relays;
+  };
+
+  static constexpr uint32_t kNoRelay = ~uint32_t(0);
+
+  MapType &map_;
+  std::size_t nodes_expanded_ = 0;
+  std::size_t nodes_held_ = 0;
+
+private:
+  void reset() {
+    map_.map_.clear();
+    nodes_expanded_ = 0;
+    nodes_held_ = 0;
+  }
+
+  void visit(Storage &storage, const NodeType &n, const NodeType &p, int g) {
+    NodeType nn(n);
+    nn.parent_ = p.hash();
+    nn.g_ = g;
+    nn.cost_ = g;
+    nn.state_ = NodeState::open;
+    storage[n.hash()] = nn;
+    map_.stats_.nodes_opened++;
+  }
+
+  // Expand a layer of one side. Return the length of the shortest path
+  // through nodes met with the other side, or -1 if none is met.
+  int expand_layer(Storage &side, const Storage &other,
+                   std::vector<NodeType> &layer, NodeType &meet) {
+    std::vector<NodeType> next;
+    int best = -1;
+    for (const NodeType &n : layer) {
+      nodes_expanded_++;
+      const int g = side.at(n.hash()).g_;
+      for (const auto &edge : map_.edges(n)) {
+        const HashType h = edge.to_.hash();
+        if (side.count(h) == 0) {
+          visit(side, edge.to_, n, g + 1);
+          next.push_back(edge.to_);
+        }
+        if (other.count(h) != 0) {
+          const int length = side.at(h).g_ + other.at(h).g_;
+          if (best < 0 || length < best) {
+            best = length;
+            meet = edge.to_;
+          }
+        }
+      }
+    }
+    layer.swap(next);
+    return best;
+  }
+
+  // Search layer by layer from the start. Return the depth of the goal, or -1
+  // if it's not reached. If @middle_depth is given and less than the depth,
+  // @middle is set to the node of that depth on a shortest path.
+  int search_layers(const NodeType &start, const NodeType &goal,
+                    int middle_depth, NodeType &middle) {
+    std::vector<NodeType> middles;
+    Layer layers[3]; // Rotated, the layer of depth d is layers[d % 3].
+    // Nodes of the layers before and at the last power of 2 depth.
+    FlatHashMap<HashType, uint32_t> saved[2];
+    layers[0].nodes.push_back(start);
+    layers[0].relays[start.hash()] =
+        middle_depth == 0 ? push(middles, start) : kNoRelay;
+
+    for (int depth = 0; !layers[depth % 3].nodes.empty(); depth++) {
+      Layer &previous = layers[(depth + 2) % 3];
+      Layer &current = layers[depth % 3];
+      Layer &next = layers[(depth + 1) % 3];
+      if (current.relays.count(goal.hash())) {
+        if (middle_depth >= 0 && middle_depth < depth)
+          middle = middles[current.relays.at(goal.hash())];
+        return depth;
+      }
+
+      // A layer is made from the two before it, so once a pair of layers
+      // repeats, the goal is never reached. Pairs are compared to the one
+      // saved at the last power of 2 depth, which finds a repeat within
+      // twice the depth it starts at.
+      if (same_nodes(previous, saved[0]) && same_nodes(current, saved[1]))
+        return -1;
+      if ((depth & (depth - 1)) == 0) {
+        saved[0] = previous.relays;
+        saved[1] = current.relays;
+      }
+
+      next.nodes.clear();
+      next.relays.clear();
+      for (const NodeType &n : current.nodes) {
+        nodes_expanded_++;
+        const uint32_t relay = current.relays.at(n.hash());
+        for (const auto &edge : map_.edges(n)) {
+          const HashType h = edge.to_.hash();
+          if (previous.relays.count(h) || current.relays.count(h)
+              || next.relays.count(h))
+            continue;
+          next.nodes.push_back(edge.to_);
+          next.relays[h] = depth + 1 == middle_depth
+              ? push(middles, edge.to_) : relay;
+        }
+      }
+      nodes_held_ = std::max(nodes_held_, previous.nodes.size()
+          + current.nodes.size() + next.nodes.size() + middles.size()
+          + saved[0].size() + saved[1].size());
+    }
+    return -1;
+  }
+
+  static bool same_nodes(const Layer &layer,
+                         const FlatHashMap<HashType, uint32_t> &nodes) {
+    if (layer.nodes.size() != nodes.size())
+      return false;
+    for (const NodeType &n : layer.nodes) {
+      if (nodes.count(n.hash()) == 0)
+        return false;
+    }
+    return true;
+  }
+
+  static uint32_t push(std::vector<NodeType> &nodes, const NodeType &n) {
+    nodes.push_back(n);
+    return nodes.size() - 1;
+  }
+
+  // Append the path from the start to the goal @depth layers away, without
+  // the start.
+  void solve(const NodeType &start, const NodeType &goal, int depth,
+             std::vector<NodeType> &path) {
+    if (depth == 0)
+      return;
+    if (depth == 1) {
+      path.push_back(goal);
+      return;
+    }
+
+    const int half = depth / 2;
+    NodeType middle;
+    search_layers(start, goal, half, middle);
+    solve(start, middle, half, path);
+    solve(middle, goal, depth - half, path);
+  }
+};
+
+template <typename MapType>
+constexpr uint32_t BreadthFirstSearch<MapType>::kNoRelay;
+
+}
+
+#endif /* FUDGE_BREADTH_FIRST_SEARCH_H_ */
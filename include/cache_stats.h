@@ -0,0 +1,41 @@
+#ifndef FUDGE_CACHE_STATS_H_
+#define FUDGE_CACHE_STATS_H_
+
+#include <cstddef>
+#include <string>
+#include <sstream>
+
+namespace fudge {
+
+class CacheStats {
+public:
+  int hits = 0;
+  int misses = 0;
+  int evictions = 0;
+  int invalidations = 0;
+  std::size_t entries = 0;
+  std::size_t bytes = 0;
+
+public:
+  void reset() {
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    invalidations = 0;
+  }
+
+  const std::string to_string() const {
+    std::ostringstream ss;
+    ss << "  cache hits:" << hits << '\n'
+       << "  cache misses:" << misses << '\n'
+       << "  cache evictions:" << evictions << '\n'
+       << "  cache invalidations:" << invalidations << '\n'
+       << "  cache entries:" << entries << '\n'
+       << "  cache bytes:" << bytes << '\n';
+    return ss.str();
+  }
+};
+
+}
+
+#endif /* FUDGE_CACHE_STATS_H_ */
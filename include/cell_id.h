@@ -0,0 +1,105 @@
+#ifndef FUDGE_CELL_ID_H_
+#define FUDGE_CELL_ID_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Helpers of cell ids. A cell id packs the coordinate of a cell into 32 bits,
+// x in the lower 16 bits and y in the upper 16 bits, so it takes half the
+// memory of a coordinate and is compared as a single integer. Coordinates
+// should be in [0, 65535), so maps are at most kMaxCellIdSide cells a side,
+// and the last cell doesn't take the id of kNoCell. The coordinate (-1, -1)
+// maps to kNoCell.
+//
+// A wide cell id packs x and y into 32 bits each, for maps of any size like
+// those of ChunkedGridMap. The coordinate (-1, -1) maps to kNoWideCell.
+
+namespace fudge {
+
+using Coord = std::pair<int,int>;
+using CellId = uint32_t;
+
+static constexpr CellId kNoCell = 0xFFFFFFFF;
+static constexpr int kMaxCellIdSide = 0xFFFF;
+
+using WideCellId = uint64_t;
+
+static constexpr WideCellId kNoWideCell = ~WideCellId(0);
+
+constexpr CellId cell_id(int x, int y) {
+  return (static_cast<CellId>(y) << 16) | (static_cast<CellId>(x) & 0xFFFF);
+}
+
+constexpr CellId cell_id(const Coord &c) {
+  return cell_id(c.first, c.second);
+}
+
+constexpr int cell_x(CellId id) {
+  return id == kNoCell ? -1 : static_cast<int>(id & 0xFFFF);
+}
+
+constexpr int cell_y(CellId id) {
+  return id == kNoCell ? -1 : static_cast<int>(id >> 16);
+}
+
+constexpr Coord cell_coord(CellId id) {
+  return Coord(cell_x(id), cell_y(id));
+}
+
+constexpr WideCellId wide_cell_id(int x, int y) {
+  return (static_cast<WideCellId>(static_cast<uint32_t>(y)) << 32)
+      | static_cast<uint32_t>(x);
+}
+
+constexpr int cell_x(WideCellId id) {
+  return static_cast<int>(static_cast<uint32_t>(id));
+}
+
+constexpr int cell_y(WideCellId id) {
+  return static_cast<int>(static_cast<uint32_t>(id >> 32));
+}
+
+constexpr Coord cell_coord(WideCellId id) {
+  return Coord(cell_x(id), cell_y(id));
+}
+
+// Return if a map of the size has a cell id for every cell.
+constexpr bool fits_cell_ids(int w, int h) {
+  return w <= kMaxCellIdSide && h <= kMaxCellIdSide;
+}
+
+// Pack a coordinate into an id of either width.
+template <typename Id>
+constexpr Id make_cell_id(const Coord &c);
+
+template <>
+constexpr CellId make_cell_id<CellId>(const Coord &c) {
+  return cell_id(c);
+}
+
+template <>
+constexpr WideCellId make_cell_id<WideCellId>(const Coord &c) {
+  return wide_cell_id(c.first, c.second);
+}
+
+inline std::vector<CellId> cell_ids(const std::vector<Coord> &coords) {
+  std::vector<CellId> ids;
+  ids.reserve(coords.size());
+  for (const Coord &c : coords)
+    ids.push_back(cell_id(c));
+  return ids;
+}
+
+template <typename Id>
+std::vector<Coord> cell_coords(const std::vector<Id> &ids) {
+  std::vector<Coord> coords;
+  coords.reserve(ids.size());
+  for (Id id : ids)
+    coords.push_back(cell_coord(id));
+  return coords;
+}
+
+}
+
+#endif /* FUDGE_CELL_ID_H_ */
@@ -0,0 +1,43 @@
+#ifndef FUDGE_CHUNKED_GRID_MAP_H_
+#define FUDGE_CHUNKED_GRID_MAP_H_
+
+#include "grid_map.h"
+#include "chunked_matrix.h"
+#include "sparse_grid_node_array.h"
+
+// This implements a grid map on a chunked matrix for maps larger than memory.
+// It's a GridMap, so edges, costs and heuristic functions are the same.
+// Weights are paged from the file by the matrix, and nodes are allocated in
+// chunks as the search explores them, so memory is proportional to the area
+// explored. Nodes keep wide cell ids, so the map could be of any size.
+
+namespace fudge {
+
+template <typename CostType = double>
+class ChunkedGridMap
+    : public GridMap<CostType, RowMajorLayout, UnitScale<CostType>,
+                     const ChunkedMatrix<CostType> &,
+                     SparseGridNodeArray<CostType>> {
+public:
+  using Base = GridMap<CostType, RowMajorLayout, UnitScale<CostType>,
+                       const ChunkedMatrix<CostType> &,
+                       SparseGridNodeArray<CostType>>;
+
+public:
+  // The matrix could be shared by maps searched one after another, which
+  // keeps its chunks in memory. The node chunk size should be a power of 2.
+  ChunkedGridMap(const ChunkedMatrix<CostType> &matrix,
+                 bool enable_diagonal = true, int node_chunk_size = 64):
+    Base(matrix, enable_diagonal, node_chunk_size) {};
+  virtual ~ChunkedGridMap() = default;
+
+public:
+  // Bytes of nodes allocated so far.
+  std::size_t node_bytes() const {
+    return this->node_array_.bytes();
+  }
+};
+
+}
+
+#endif /* FUDGE_CHUNKED_GRID_MAP_H_ */
@@ -0,0 +1,268 @@
+#ifndef FUDGE_CHUNKED_MATRIX_H_
+#define FUDGE_CHUNKED_MATRIX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "util/log.h"
+#include "binary_map.h"
+#include "cache_stats.h"
+#include "vertex_matrix.h"
+
+// This implements a weight matrix too large to be held in memory. The file
+// stores square chunks of weights one after another. Chunks are read from the
+// file on demand, and at most a fixed count of them are kept in memory in LRU
+// order. Chunks on the right and bottom edges are padded with obstacles.
+
+namespace fudge {
+
+struct ChunkedMapHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  int32_t width;
+  int32_t height;
+  int32_t chunk_size;       // Width and height of a chunk, a power of 2.
+  uint32_t weight_type;
+  uint32_t weight_size;
+  uint32_t reserved0;
+  uint64_t payload_offset;
+  uint64_t chunk_bytes;
+  uint8_t reserved[8];
+};
+
+static_assert(sizeof(ChunkedMapHeader) == 64, "Unexpected header size.");
+
+static constexpr char kChunkedMapMagic[8] {'F','U','D','G','E','C','H','K'};
+static constexpr uint32_t kChunkedMapVersion = 1;
+
+// Return log2 of the chunk size, or -1 if it's not a power of 2.
+inline int chunk_shift(int chunk_size) {
+  if (chunk_size <= 0 || (chunk_size & (chunk_size - 1)) != 0)
+    return -1;
+  int shift = 0;
+  while ((1 << shift) < chunk_size)
+    shift++;
+  return shift;
+}
+
+// Write a chunked map file. The weight of each cell is given by the function
+// weight(x, y), so that maps larger than memory could be written one chunk at
+// a time.
+template <typename WeightType, typename WeightFunction>
+bool write_chunked_map(const std::string &filename, int width, int height,
+                       int chunk_size, WeightFunction weight) {
+  if (width < 0 || height < 0 || chunk_shift(chunk_size) < 0) {
+    ERROR("Invalid chunked map of %dx%d with chunk size %d.", width, height,
+          chunk_size);
+    return false;
+  }
+
+  ChunkedMapHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kChunkedMapMagic, sizeof(header.magic));
+  header.version = kChunkedMapVersion;
+  header.header_size = sizeof(header);
+  header.width = width;
+  header.height = height;
+  header.chunk_size = chunk_size;
+  header.weight_type = BinaryMapType<WeightType>::code;
+  header.weight_size = sizeof(WeightType);
+  header.payload_offset = sizeof(header);
+  header.chunk_bytes = static_cast<uint64_t>(chunk_size) * chunk_size
+      * sizeof(WeightType);
+
+  std::ofstream ofs(filename, std::ios::binary);
+  if (!ofs.is_open()) {
+    ERROR("Failed to open %s for writing.", filename.c_str());
+    return false;
+  }
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  const int chunks_x = (width + chunk_size - 1) / chunk_size;
+  const int chunks_y = (height + chunk_size - 1) / chunk_size;
+  std::vector<WeightType> chunk(chunk_size * chunk_size);
+  for (int cy = 0; cy < chunks_y; cy++) {
+    for (int cx = 0; cx < chunks_x; cx++) {
+      for (int y = 0; y < chunk_size; y++) {
+        for (int x = 0; x < chunk_size; x++) {
+          const int wx = cx * chunk_size + x;
+          const int wy = cy * chunk_size + y;
+          chunk[y * chunk_size + x] = (wx < width && wy < height)
+              ? static_cast<WeightType>(weight(wx, wy))
+              : static_cast<WeightType>(-1);
+        }
+      }
+      ofs.write(reinterpret_cast<const char *>(chunk.data()),
+                header.chunk_bytes);
+    }
+  }
+  return ofs.good();
+}
+
+template <typename WeightType>
+bool write_chunked_map(const std::string &filename, int width, int height,
+                       int chunk_size, const std::vector<WeightType> &matrix) {
+  if (matrix.size() != static_cast<std::size_t>(width) * height) {
+    ERROR("Matrix size %zu does not match %dx%d.", matrix.size(), width,
+          height);
+    return false;
+  }
+  return write_chunked_map<WeightType>(filename, width, height, chunk_size,
+      [&](int x, int y) { return matrix[y * width + x]; });
+}
+
+// A weight matrix paged from a chunked map file. It has the same interface
+// as VertexMatrix. Reading a weight is not thread safe since it may load a
+// chunk. If a chunk could not be read, an error is logged and its cells are
+// treated as obstacles.
+template <typename WeightType>
+class ChunkedMatrix {
+public:
+  // At most max_chunks chunks are kept in memory.
+  explicit ChunkedMatrix(const std::string &filename,
+                         std::size_t max_chunks = 64)
+    : max_chunks_(std::max<std::size_t>(max_chunks, 1)) {
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      ERROR("File not found: %s", filename.c_str());
+      return;
+    }
+
+    ChunkedMapHeader header;
+    if (::pread(fd_, &header, sizeof(header), 0) != sizeof(header)
+        || std::memcmp(header.magic, kChunkedMapMagic, sizeof(header.magic))
+            != 0 || header.version != kChunkedMapVersion
+        || chunk_shift(header.chunk_size) < 0) {
+      ERROR("Invalid chunked map: %s", filename.c_str());
+    } else if (header.weight_type != BinaryMapType<WeightType>::code
+        || header.weight_size != sizeof(WeightType)) {
+      ERROR("Unexpected weight type %u in %s.", header.weight_type,
+            filename.c_str());
+    } else {
+      width_ = header.width;
+      height_ = header.height;
+      chunk_size_ = header.chunk_size;
+      shift_ = chunk_shift(chunk_size_);
+      chunks_x_ = (width_ + chunk_size_ - 1) / chunk_size_;
+      payload_offset_ = header.payload_offset;
+      chunk_bytes_ = header.chunk_bytes;
+      return;
+    }
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+  ChunkedMatrix(const ChunkedMatrix &) = delete;
+  ChunkedMatrix &operator =(const ChunkedMatrix &) = delete;
+
+  virtual ~ChunkedMatrix() {
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+public:
+  int width_ = 0;
+  int height_ = 0;
+  int chunk_size_ = 0;
+  mutable CacheStats stats_;
+
+public:
+  bool is_open() const {
+    return fd_ >= 0;
+  }
+
+  // The last chunk used is already the most recent in the LRU order, as any
+  // other chunk is reached through load(), which moves it to the front. So
+  // the fast path leaves the order as it is.
+  WeightType weight(Coord coord) const {
+    const int64_t key = chunk_key(coord);
+    if (key != last_key_) {
+      last_chunk_ = load(key);
+      last_key_ = key;
+    }
+    const int mask = chunk_size_ - 1;
+    return last_chunk_[((coord.second & mask) << shift_)
+        + (coord.first & mask)];
+  }
+
+  bool is_off(Coord coord) const {
+    return (coord.first < 0 || coord.first >= width_ ||
+        coord.second < 0 || coord.second >= height_);
+  }
+
+  bool is_passable(Coord coord,
+      WeightType threhold = std::numeric_limits<WeightType>::max()) const {
+    if (is_off(coord))
+      return false;
+    WeightType w = weight(coord);
+    return w >= 0 && w <= threhold;
+  }
+
+private:
+  struct Entry {
+    std::vector<WeightType> weights;
+    std::list<int64_t>::iterator lru;
+  };
+
+  int fd_ = -1;
+  int shift_ = 0;
+  int chunks_x_ = 0;
+  uint64_t payload_offset_ = 0;
+  uint64_t chunk_bytes_ = 0;
+  std::size_t max_chunks_;
+  mutable std::unordered_map<int64_t, Entry> chunks_;
+  mutable std::list<int64_t> lru_;  // Most recently used first.
+  mutable int64_t last_key_ = -1;
+  mutable const WeightType *last_chunk_ = nullptr;
+
+private:
+  int64_t chunk_key(const Coord &c) const {
+    return static_cast<int64_t>(c.second >> shift_) * chunks_x_
+        + (c.first >> shift_);
+  }
+
+  // Return the weights of the chunk, reading it from the file if needed.
+  const WeightType *load(int64_t key) const {
+    auto i = chunks_.find(key);
+    if (i != chunks_.end()) {
+      stats_.hits++;
+      lru_.splice(lru_.begin(), lru_, i->second.lru);
+      return i->second.weights.data();
+    }
+
+    stats_.misses++;
+    while (chunks_.size() >= max_chunks_) {
+      chunks_.erase(lru_.back());
+      lru_.pop_back();
+      stats_.evictions++;
+    }
+
+    lru_.push_front(key);
+    Entry &e = chunks_[key];
+    e.lru = lru_.begin();
+    e.weights.resize(chunk_size_ * chunk_size_);
+    const off_t offset = payload_offset_ + key * chunk_bytes_;
+    if (::pread(fd_, e.weights.data(), chunk_bytes_, offset)
+        != static_cast<ssize_t>(chunk_bytes_)) {
+      ERROR("Failed to read chunk %lld.", static_cast<long long>(key));
+      std::fill(e.weights.begin(), e.weights.end(),
+                static_cast<WeightType>(-1));
+    }
+    stats_.entries = chunks_.size();
+    stats_.bytes = chunks_.size() * chunk_bytes_;
+    return e.weights.data();
+  }
+};
+
+}
+
+#endif /* FUDGE_CHUNKED_MATRIX_H_ */
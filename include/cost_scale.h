@@ -0,0 +1,66 @@
+#ifndef FUDGE_COST_SCALE_H_
+#define FUDGE_COST_SCALE_H_
+
+#include <cstdint>
+
+// A scale gives the edge weights of a grid map in units of its cost type.
+//
+// With UnitScale, a straight move costs 1 and a diagonal move costs 1.4143,
+// casted to the cost type. Floating point costs are compared with an epsilon.
+//
+// With FixedScale, costs are fixed-point numbers held in 32-bit integers: a
+// cost c is stored as c * Scale rounded to the nearest integer. Weights of the
+// matrix stay plain integers, and edge costs come out scaled. Comparisons are
+// exact, and costs could be used as keys of integer bucket queues.
+
+namespace fudge {
+
+template <typename CostType>
+struct UnitScale {
+  static constexpr CostType kStraightEdgeWeight = static_cast<CostType>(1.0);
+  static constexpr CostType kDiagonalEdgeWeight =
+      static_cast<CostType>(1.4143);
+
+  // Size of each bucket of the open list.
+  static constexpr double kBucketSize = 1.4143;
+};
+
+template <int32_t Scale = 1000>
+struct FixedScale {
+  static_assert(Scale > 0, "Scale should be positive.");
+
+  static constexpr int32_t kScale = Scale;
+  static constexpr int32_t kStraightEdgeWeight = Scale;
+  static constexpr int32_t kDiagonalEdgeWeight =
+      static_cast<int32_t>(1.41421356 * Scale + 0.5);
+
+  static constexpr double kBucketSize = kDiagonalEdgeWeight;
+
+  static constexpr int32_t to_fixed(double c) {
+    return static_cast<int32_t>(c * Scale + (c < 0 ? -0.5 : 0.5));
+  }
+
+  static constexpr double to_double(int32_t c) {
+    return static_cast<double>(c) / Scale;
+  }
+};
+
+template <typename CostType>
+constexpr CostType UnitScale<CostType>::kStraightEdgeWeight;
+template <typename CostType>
+constexpr CostType UnitScale<CostType>::kDiagonalEdgeWeight;
+template <typename CostType>
+constexpr double UnitScale<CostType>::kBucketSize;
+
+template <int32_t Scale>
+constexpr int32_t FixedScale<Scale>::kScale;
+template <int32_t Scale>
+constexpr int32_t FixedScale<Scale>::kStraightEdgeWeight;
+template <int32_t Scale>
+constexpr int32_t FixedScale<Scale>::kDiagonalEdgeWeight;
+template <int32_t Scale>
+constexpr double FixedScale<Scale>::kBucketSize;
+
+}
+
+#endif /* FUDGE_COST_SCALE_H_ */
@@ -0,0 +1,171 @@
+#ifndef FUDGE_FLAT_HASH_MAP_H_
+#define FUDGE_FLAT_HASH_MAP_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// This is a hash table with open addressing, for looking up explored nodes of
+// a search. Entries are appended to a contiguous arena and never erased. The
+// table itself is an array of 64-bit slots with linear probing. Each slot
+// keeps the index of an entry and the upper bits of its hash, so most probes
+// don't touch the arena at all. Growing the table rebuilds the slots only, and
+// entries stay where they are.
+//
+// It has the part of the interface of std::map used by PositionMap. Unlike
+// std::map, references to values are invalidated by insertions.
+
+namespace fudge {
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+  explicit FlatHashMap(std::size_t capacity = 64) {
+    std::size_t n = 16;
+    while (n < capacity * 2)
+      n <<= 1;
+    slots_.assign(n, kEmpty);
+    mask_ = n - 1;
+  };
+  virtual ~FlatHashMap() = default;
+
+public:
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+  std::size_t count(const Key &key) const {
+    return find(key) != kNotFound ? 1 : 0;
+  }
+
+  Value &at(const Key &key) {
+    const uint32_t i = find(key);
+    if (i == kNotFound)
+      throw std::out_of_range("FlatHashMap::at");
+    return entries_[i].second;
+  }
+
+  const Value &at(const Key &key) const {
+    const uint32_t i = find(key);
+    if (i == kNotFound)
+      throw std::out_of_range("FlatHashMap::at");
+    return entries_[i].second;
+  }
+
+  // Return the value of the key, inserting a default one if there's none.
+  Value &operator[](const Key &key) {
+    const uint64_t h = hash(key);
+    std::size_t s = h & mask_;
+    while (slots_[s] != kEmpty) {
+      if (tag(slots_[s]) == tag(h)
+          && entries_[index(slots_[s])].first == key)
+        return entries_[index(slots_[s])].second;
+      s = (s + 1) & mask_;
+    }
+
+    const uint32_t i = entries_.size();
+    entries_.push_back(std::make_pair(key, Value()));
+    slots_[s] = (h & kTagMask) | i;
+    if (entries_.size() * 4 > slots_.size() * 3)
+      grow();
+    return entries_[i].second;
+  }
+
+  // Count entries of other keys with the same hash code as the key. Such keys
+  // share the home slot and tag, so only the run of slots from there is seen.
+  std::size_t count_collisions(const Key &key) const {
+    const uint64_t h = hash(key);
+    const std::size_t code = Hash()(key);
+    std::size_t collisions = 0;
+    for (std::size_t s = h & mask_; slots_[s] != kEmpty; s = (s + 1) & mask_) {
+      if (tag(slots_[s]) != tag(h))
+        continue;
+      const Key &k = entries_[index(slots_[s])].first;
+      if (Hash()(k) == code && !(k == key))
+        collisions++;
+    }
+    return collisions;
+  }
+
+  void clear() {
+    entries_.clear();
+    std::fill(slots_.begin(), slots_.end(), kEmpty);
+  }
+
+  // Entries in the order of insertion.
+  const std::vector<std::pair<Key, Value>> &entries() const {
+    return entries_;
+  }
+
+  std::size_t memory_usage() const {
+    return slots_.size() * sizeof(uint64_t)
+        + entries_.capacity() * sizeof(std::pair<Key, Value>);
+  }
+
+private:
+  static constexpr uint64_t kEmpty = ~uint64_t(0);
+  static constexpr uint32_t kNotFound = ~uint32_t(0);
+  static constexpr uint64_t kTagMask = ~uint64_t(0) << 32;
+
+  std::vector<uint64_t> slots_; // Hash tag in upper 32 bits, index in lower.
+  std::vector<std::pair<Key, Value>> entries_;
+  std::size_t mask_ = 0;
+
+private:
+  // Mix the bits, as std::hash of integers is usually the identity.
+  static uint64_t hash(const Key &key) {
+    uint64_t h = Hash()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static uint64_t tag(uint64_t slot) {
+    return slot >> 32;
+  }
+
+  static uint32_t index(uint64_t slot) {
+    return static_cast<uint32_t>(slot);
+  }
+
+  uint32_t find(const Key &key) const {
+    const uint64_t h = hash(key);
+    std::size_t s = h & mask_;
+    while (slots_[s] != kEmpty) {
+      if (tag(slots_[s]) == tag(h)
+          && entries_[index(slots_[s])].first == key)
+        return index(slots_[s]);
+      s = (s + 1) & mask_;
+    }
+    return kNotFound;
+  }
+
+  void grow() {
+    slots_.assign(slots_.size() * 2, kEmpty);
+    mask_ = slots_.size() - 1;
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+      const uint64_t h = hash(entries_[i].first);
+      std::size_t s = h & mask_;
+      while (slots_[s] != kEmpty)
+        s = (s + 1) & mask_;
+      slots_[s] = (h & kTagMask) | i;
+    }
+  }
+};
+
+template <typename Key, typename Value, typename Hash>
+constexpr uint64_t FlatHashMap<Key, Value, Hash>::kEmpty;
+template <typename Key, typename Value, typename Hash>
+constexpr uint32_t FlatHashMap<Key, Value, Hash>::kNotFound;
+template <typename Key, typename Value, typename Hash>
+constexpr uint64_t FlatHashMap<Key, Value, Hash>::kTagMask;
+
+}
+
+#endif /* FUDGE_FLAT_HASH_MAP_H_ */
@@ -0,0 +1,93 @@
+#ifndef FUDGE_GRID_DIJKSTRA_H_
+#define FUDGE_GRID_DIJKSTRA_H_
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include "vertex_matrix.h"
+#include "grid_map.h"
+
+// This implements a single source Dijkstra search over a tile based grid.
+// Edges are the same as the ones of GridMap: moving to a passable neighbor
+// costs the weight of the neighbor multiplied by the straight or diagonal edge
+// weight. It is used to build tables answering queries without search.
+
+namespace fudge {
+
+// Offsets of the 8 neighbors, in the same order as GridMap.
+static constexpr int kNeighborX[8] {-1, 0, 1, -1, 1, -1, 0, 1};
+static constexpr int kNeighborY[8] {-1,-1,-1,  0, 0,  1, 1, 1};
+
+// Indices of the 4 straight neighbors among the 8 neighbors.
+static constexpr int kStraightNeighbors[4] {1, 3, 4, 6};
+
+static constexpr unsigned char kNoMove = 0xFF;
+
+template <typename CostType>
+CostType neighbor_edge_weight(int k) {
+  return (kNeighborX[k] == 0 || kNeighborY[k] == 0)
+      ? GridMap<CostType>::kStraightEdgeWeight
+      : GridMap<CostType>::kDiagonalEdgeWeight;
+}
+
+// Calculate costs from the source to every node (or from every node to the
+// source if reverse is set) into dist, with -1 for unreachable nodes. If
+// first_moves is given, it receives the index of the neighbor to move to from
+// the source in order to reach each node, or kNoMove.
+template <typename CostType>
+void grid_dijkstra(const VertexMatrix<CostType> &vertex_matrix,
+                   const Coord &source, bool enable_diagonal,
+                   std::vector<CostType> &dist,
+                   std::vector<unsigned char> *first_moves = nullptr,
+                   bool reverse = false) {
+  typedef std::pair<CostType, int> Entry; // Cost and index.
+  const int w = vertex_matrix.width_;
+  const int size = w * vertex_matrix.height_;
+
+  dist.assign(size, static_cast<CostType>(-1));
+  if (first_moves != nullptr)
+    first_moves->assign(size, kNoMove);
+  if (!vertex_matrix.is_passable(source))
+    return;
+
+  std::vector<bool> closed(size, false);
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  const int s = source.second * w + source.first;
+  dist[s] = 0;
+  open.push(Entry(0, s));
+
+  while (!open.empty()) {
+    const Entry top = open.top();
+    open.pop();
+    if (closed[top.second])
+      continue; // Stale entry left by a cheaper path.
+    closed[top.second] = true;
+
+    const Coord c(top.second % w, top.second / w);
+    for (int k = 0; k < 8; k++) {
+      if (!enable_diagonal && kNeighborX[k] != 0 && kNeighborY[k] != 0)
+        continue;
+
+      const Coord n(c.first + kNeighborX[k], c.second + kNeighborY[k]);
+      if (!vertex_matrix.is_passable(n))
+        continue;
+
+      const int j = n.second * w + n.first;
+      if (closed[j])
+        continue;
+
+      const CostType g = top.first + neighbor_edge_weight<CostType>(k)
+          * vertex_matrix.weight(reverse ? c : n);
+      if (dist[j] == -1 || g < dist[j]) {
+        dist[j] = g;
+        if (first_moves != nullptr)
+          (*first_moves)[j] = top.second == s ? k : (*first_moves)[top.second];
+        open.push(Entry(g, j));
+      }
+    }
+  }
+}
+
+}
+
+#endif /* FUDGE_GRID_DIJKSTRA_H_ */
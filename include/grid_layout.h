@@ -0,0 +1,126 @@
+#ifndef FUDGE_GRID_LAYOUT_H_
+#define FUDGE_GRID_LAYOUT_H_
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "morton.h"
+
+// Layouts map coordinates of a grid to indices of the storage. Row-major
+// order keeps horizontal neighbors close, but vertical and diagonal neighbors
+// are a row apart, on other cache lines and often on other pages. Blocked and
+// Morton layouts keep square areas of cells close in memory.
+//
+// A layout is constructed with the width and height of the grid, and gives
+// the size of the storage, which could be larger than the count of cells.
+
+namespace fudge {
+
+using Coord = std::pair<int,int>;
+
+class RowMajorLayout {
+public:
+  RowMajorLayout(int w, int h) : w_(w), h_(h) {};
+
+public:
+  std::size_t index(const Coord &c) const {
+    return static_cast<std::size_t>(c.second) * w_ + c.first;
+  }
+
+  std::size_t size() const {
+    return static_cast<std::size_t>(w_) * h_;
+  }
+
+private:
+  int w_;
+  int h_;
+};
+
+// Row-major order of a grid whose size is known at compile time, so the index
+// is computed with a constant width. It should be constructed with the same
+// width and height.
+template <int kWidth, int kHeight>
+class FixedRowMajorLayout {
+  static_assert(kWidth > 0 && kHeight > 0, "Size should be positive.");
+
+public:
+  FixedRowMajorLayout(int w, int h) {
+    assert(w == kWidth && h == kHeight);
+  };
+
+public:
+  static constexpr std::size_t index(const Coord &c) {
+    return static_cast<std::size_t>(c.second) * kWidth + c.first;
+  }
+
+  static constexpr std::size_t size() {
+    return static_cast<std::size_t>(kWidth) * kHeight;
+  }
+};
+
+// Tell if cells of a layout are stored in row-major order, so row-major
+// weights could be used as they are.
+template <typename Layout>
+struct IsRowMajor : std::false_type {};
+
+template <>
+struct IsRowMajor<RowMajorLayout> : std::true_type {};
+
+template <int kWidth, int kHeight>
+struct IsRowMajor<FixedRowMajorLayout<kWidth, kHeight>> : std::true_type {};
+
+// Square blocks of kBlockSize x kBlockSize cells stored one after another in
+// row-major order. The block size should be a power of 2.
+template <int kBlockSize = 8>
+class BlockedLayout {
+  static_assert((kBlockSize & (kBlockSize - 1)) == 0,
+                "Block size should be a power of 2.");
+
+public:
+  BlockedLayout(int w, int h)
+    : blocks_x_((w + kBlockSize - 1) / kBlockSize),
+      blocks_y_((h + kBlockSize - 1) / kBlockSize) {};
+
+public:
+  std::size_t index(const Coord &c) const {
+    const std::size_t block = static_cast<std::size_t>(c.second / kBlockSize)
+        * blocks_x_ + c.first / kBlockSize;
+    return block * kBlockSize * kBlockSize
+        + (c.second % kBlockSize) * kBlockSize + c.first % kBlockSize;
+  }
+
+  std::size_t size() const {
+    return static_cast<std::size_t>(blocks_x_) * blocks_y_
+        * kBlockSize * kBlockSize;
+  }
+
+private:
+  int blocks_x_;
+  int blocks_y_;
+};
+
+// Z-order of cells. Width and height should be at most 65536. The storage of
+// a grid which is far from square has gaps.
+class MortonLayout {
+public:
+  MortonLayout(int w, int h)
+    : size_(w > 0 && h > 0 ? morton_code(w - 1, h - 1) + std::size_t(1) : 0)
+    {};
+
+public:
+  std::size_t index(const Coord &c) const {
+    return morton_code(c.first, c.second);
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+private:
+  std::size_t size_;
+};
+
+}
+
+#endif /* FUDGE_GRID_LAYOUT_H_ */
@@ -2,41 +2,83 @@
 #define FUDGE_GRID_MAP_H_
 
 #include <algorithm>
+#include <limits>
 #include <math.h>
 #include "util/log.h"
 #include "node_state.h"
 #include "map.h"
 #include "vertex_matrix.h"
+#include "versioned_matrix.h"
 #include "grid_node_array.h"
 #include "binary_heap.h"
 #include "hot_queue.h"
 #include "search_stats.h"
+#include "cost_scale.h"
 
 // This implements a square tile based grid map.
-// It could accept different cost type like int and double.
-// By default diagonal move is allowed.
+// It could accept different cost type like int and double. Edge weights are
+// given by the scale, so costs could be fixed-point integers, see
+// cost_scale.h.
+// By default diagonal move is allowed, even past the corner of an obstacle.
+// Corners are kept whole with enable_corner_cutting(false), so a diagonal
+// move needs both cells beside it passable, as Moving AI benchmarks expect.
+// Weights and nodes are stored in the order of the layout, see grid_layout.h.
+// Nodes keep their coordinates as cell ids, and paths could be taken as cell
+// ids too, see cell_id.h. So maps are at most 65535 cells a side, unless the
+// node array keeps wide cell ids.
+// Obstacles are looked up in the passability bitmap of the matrix if it
+// carries one, like a snapshot of VersionedMatrix, which is kept in sync with
+// its weights. Otherwise the weights are read as they are, so a map made from
+// a vector sees later edits of the vector, as it always did, unless the
+// layout isn't row-major and the weights were copied. A bitmap could be made
+// for any map with use_passability_bitmap(), after which weights edited in
+// place are seen once update() is called for their cells.
+// Weights could be taken from another kind of matrix with the interface of
+// VertexMatrix, and nodes kept in another kind of array, like ChunkedGridMap
+// does. A matrix which can't be copied is given as a reference type.
 
 namespace fudge {
 
-template <typename CostType = double>
+template <typename CostType = double, typename Layout = RowMajorLayout,
+          typename Scale = UnitScale<CostType>,
+          typename Matrix = VertexMatrix<CostType, Layout>,
+          typename NodeArray = GridNodeArray<CostType, Layout>>
 class GridMap : public Map<Coord, CostType> {
 
 public:
   GridMap(int w, int h, const std::vector<CostType> &matrix,
           bool enable_diagonal = true):
     vertex_matrix_(w, h, matrix), node_array_(w, h),
-    enable_diagonal_(enable_diagonal) {};
+    open_list_(Scale::kBucketSize), enable_diagonal_(enable_diagonal),
+    passability_(passability_of(vertex_matrix_)) {};
+  GridMap(const Matrix &vertex_matrix, bool enable_diagonal = true):
+    vertex_matrix_(vertex_matrix),
+    node_array_(vertex_matrix.width_, vertex_matrix.height_),
+    open_list_(Scale::kBucketSize), enable_diagonal_(enable_diagonal),
+    passability_(passability_of(vertex_matrix_)) {};
   virtual ~GridMap() = default;
 
 public:
-  static constexpr CostType kDiagonalEdgeWeight = static_cast<CostType>(1.4143);
-  static constexpr CostType kStraightEdgeWeight = static_cast<CostType>(1.0);
+  using Node = typename NodeArray::Node;
+
+protected:
+  // Make the node array from the arguments given.
+  template <typename... NodeArgs>
+  GridMap(const Matrix &vertex_matrix, bool enable_diagonal,
+          NodeArgs... node_args):
+    vertex_matrix_(vertex_matrix), node_array_(node_args...),
+    open_list_(Scale::kBucketSize), enable_diagonal_(enable_diagonal),
+    passability_(passability_of(vertex_matrix_)) {};
+
+public:
+  static constexpr CostType kDiagonalEdgeWeight = Scale::kDiagonalEdgeWeight;
+  static constexpr CostType kStraightEdgeWeight = Scale::kStraightEdgeWeight;
 
 public:
   static constexpr CostType manhattan_distance(
       const Coord &n0, const Coord &n1) {
     return static_cast<CostType>(
-        abs(x(n1) - x(n0)) + abs(y(n1) - y(n0)));
+        (abs(x(n1) - x(n0)) + abs(y(n1) - y(n0))) * kStraightEdgeWeight);
   }
 
   static CostType diagonal_distance (const Coord &n0, const Coord &n1) {
@@ -51,7 +93,7 @@ public:
   static CostType duclidean_distance(const Coord &n0, const Coord &n1) {
     int dx = abs(x(n1) - x(n0));
     int dy = abs(y(n1) - y(n0));
-    return static_cast<CostType>(sqrt(dx*dx + dy*dy));
+    return static_cast<CostType>(sqrt(dx*dx + dy*dy) * kStraightEdgeWeight);
   }
 
 public:
@@ -70,7 +112,7 @@ public:
       coords = std::move(coord_4_neighbors(n));
 
     for (auto c : coords) {
-      if (vertex_matrix_.is_passable(c)) {
+      if (is_passable(c) && (cut_corners_ || !cuts_corner(n, c))) {
         es.push_back(Edge<Coord, CostType>(n, c, edge_cost(n, c)));
       }
     }
@@ -119,11 +161,11 @@ public:
   }
 
   Coord take_out_top_node() override {
-    GridNode<CostType> *gn = open_list_.remove_front();
+    Node *gn = open_list_.remove_front();
     gn->state_ = NodeState::closed;
     stats_.nodes_closed++;
     DEBUG("front node removed: %s", gn->to_string().c_str());
-    return gn->c_;
+    return gn->c();
   }
 
   virtual void increase_node_priority(const Coord &n, CostType g, CostType h,
@@ -137,24 +179,68 @@ public:
   }
 
   virtual std::vector<Coord> get_path(const Coord &n) override {
-    std::vector<Coord> path;
-    Coord p = n;
-    while (node(p)->parent_->c_ != p){
-      path.push_back(p);
-      node(p)->state_ = NodeState::result;
-      p = node(p)->parent_->c_;
+    return cell_coords(get_cell_path(n));
+  }
+
+public:
+  // Return the path found as cell ids, in the same order as get_path().
+  std::vector<typename Node::Id> get_cell_path(const Coord &n) {
+    std::vector<typename Node::Id> path;
+    Node *p = node(n);
+    while (p->parent_ != p) {
+      path.push_back(p->id_);
+      p->state_ = NodeState::result;
+      p = p->parent_;
     }
 
     node(n)->state_ = NodeState::goal;
-    node(p)->state_ = NodeState::start;
+    p->state_ = NodeState::start;
     return path;
   }
 
-public:
-  GridNode<CostType>* node(const Coord &n) const {
+  Node* node(const Coord &n) const {
     return node_array_.node(n);
   }
 
+  void enable_corner_cutting(bool enable) {
+    cut_corners_ = enable;
+  }
+
+  // Look obstacles up in a bitmap of cells with weights not above the
+  // threshold, made of the weights as they are now. Call update() after
+  // editing weights in place so that the bitmap sees them.
+  void use_passability_bitmap(
+      CostType threshold = std::numeric_limits<CostType>::max()) {
+    own_passability_ = std::make_shared<PassabilityBitmap>(
+        vertex_matrix_.width_, vertex_matrix_.height_);
+    passability_threshold_ = threshold;
+    passability_ = own_passability_;
+    update(CellRegion(0, 0, vertex_matrix_.width_ - 1,
+                      vertex_matrix_.height_ - 1));
+  }
+
+  // Take the weights of cells in the region again into the bitmap made by
+  // use_passability_bitmap(). Without one, weights are read as they are, or
+  // the bitmap of the matrix is in sync already.
+  void update(const CellRegion &region) {
+    if (!own_passability_)
+      return;
+    const int x1 = std::min(region.x1_, vertex_matrix_.width_ - 1);
+    const int y1 = std::min(region.y1_, vertex_matrix_.height_ - 1);
+    for (int y = std::max(region.y0_, 0); y <= y1; y++) {
+      for (int x = std::max(region.x0_, 0); x <= x1; x++)
+        own_passability_->set(Coord(x, y), vertex_matrix_.is_passable(
+            Coord(x, y), passability_threshold_));
+    }
+  }
+
+  // The cell should be on the map or next to it.
+  bool is_passable(const Coord &n) const {
+    if (passability_)
+      return passability_->is_passable(n);
+    return vertex_matrix_.is_passable(n);
+  }
+
   const std::string to_string() const {
     static constexpr char syms[] = {
         ' ', 'o', '-', '@','S','G'
@@ -180,14 +266,31 @@ public:
   }
 
 public:
-  const VertexMatrix<CostType> vertex_matrix_;
+  const Matrix vertex_matrix_;
   SearchStats stats_;
 
 protected:
-  GridNodeArray<CostType> node_array_;
-  HotQueue<GridNode<CostType>*, CostType, GridNode<CostType>,
-      BinaryHeap<GridNode<CostType>*, CostType, GridNode<CostType>>> open_list_;
+  NodeArray node_array_;
+  HotQueue<Node*, CostType, Node,
+      BinaryHeap<Node*, CostType, Node>> open_list_;
   bool enable_diagonal_;
+  bool cut_corners_ = true;
+  std::shared_ptr<const PassabilityBitmap> passability_; // May be null.
+  std::shared_ptr<PassabilityBitmap> own_passability_;
+  CostType passability_threshold_ = std::numeric_limits<CostType>::max();
+
+protected:
+  static std::shared_ptr<const PassabilityBitmap> passability_of(
+      const VertexMatrix<CostType, Layout> &vertex_matrix) {
+    return vertex_matrix.passability();
+  }
+
+  // Other matrices carry no bitmap.
+  template <typename OtherMatrix>
+  static std::shared_ptr<const PassabilityBitmap> passability_of(
+      const OtherMatrix &) {
+    return nullptr;
+  }
 
 protected:
   static constexpr int x(const Coord &n) {
@@ -251,12 +354,23 @@ protected:
   }
 
 protected:
+  // Return true if a diagonal move passes an obstacle beside it.
+  bool cuts_corner(const Coord &n0, const Coord &n1) const {
+    return x(n0) != x(n1) && y(n0) != y(n1)
+        && (!is_passable(Coord(x(n1), y(n0)))
+            || !is_passable(Coord(x(n0), y(n1))));
+  }
+
   CostType edge_cost(const Coord &n0, const Coord &n1) const {
     return vertex_matrix_.weight(n1) * edge_weight(n0, n1);
   }
 
 };
 
+// Grid map with fixed-point costs, see FixedScale.
+template <int32_t Scale = 1000, typename Layout = RowMajorLayout>
+using FixedGridMap = GridMap<int32_t, Layout, FixedScale<Scale>>;
+
 }
 
 #endif /* FUDGE_GRID_MAP_H_ */
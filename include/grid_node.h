@@ -4,34 +4,49 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include "node_state.h"
 #include "map.h"
+#include "cell_id.h"
 
 namespace fudge {
 
-using Coord=std::pair<int,int>;
+// Hash of a coordinate for unordered containers.
+struct CoordHash {
+  std::size_t operator()(const Coord &c) const {
+    return (static_cast<std::size_t>(static_cast<unsigned int>(c.second))
+        << 16) ^ static_cast<std::size_t>(static_cast<unsigned int>(c.first));
+  }
+};
 
 // This represents a node in a tiled grid map that holds cost, state,
-// coordinate, and a pointer to its parent node, .
-template<typename CostType>
+// coordinate, and a pointer to its parent node. The coordinate is kept as a
+// cell id, or a wide cell id for maps too large for cell ids, see cell_id.h.
+template<typename CostType, typename IdType = CellId>
 class GridNode {
 public:
-  GridNode(int x, int y, CostType f) : c_(x,y), f_(f) {};
-  GridNode(Coord c, CostType f) : c_(c), f_(f) {};
+  using Id = IdType;
+
+public:
+  GridNode(int x, int y, CostType f)
+    : id_(make_cell_id<Id>(Coord(x, y))), f_(f) {};
+  GridNode(Coord c, CostType f) : id_(make_cell_id<Id>(c)), f_(f) {};
   GridNode() {};
 
 public:
-  Coord c_ = {-1, -1};
+  Id id_ = ~Id(0);
+  NodeState state_ = NodeState::unexplored;
   CostType g_ = -1; // cost from start to current
   CostType f_ = -1; // total cost (current + estimated)
-  NodeState state_ = NodeState::unexplored;
 
 public:
   GridNode *parent_ = nullptr;
 
 public:
+  // Integer costs are compared exactly, others with an epsilon.
   static constexpr bool less_priority(const GridNode *a, const GridNode *b) {
-    return a->f_ - b->f_ > 0.00001;
+    return std::is_integral<CostType>::value
+        ? a->f_ > b->f_ : a->f_ - b->f_ > 0.00001;
   }
 
   static constexpr double get_priority(const GridNode *a) {
@@ -43,31 +58,31 @@ public:
   }
 
 public:
-  constexpr int x() const {
-    return c_.first;
+  constexpr Coord c() const {
+    return cell_coord(id_);
   }
 
-  constexpr int y() const {
-    return c_.second;
+  constexpr int x() const {
+    return cell_x(id_);
   }
 
-  void x(int x1) {
-    c_.first = x1;
+  constexpr int y() const {
+    return cell_y(id_);
   }
 
-  void y(int y1) {
-    c_.second = y1;
+  void c(const Coord &c1) {
+    id_ = make_cell_id<Id>(c1);
   }
 
 public:
   friend std::ostream& operator <<(std::ostream &out,
-                                   GridNode<CostType> const &n) {
+                                   GridNode const &n) {
     out << n.f_;
     return out;
   }
 
   friend std::ostream& operator <<(std::ostream &out,
-                                   GridNode<CostType>* const &n) {
+                                   GridNode* const &n) {
     out << n->f_;
     return out;
   }
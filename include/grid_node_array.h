@@ -4,16 +4,27 @@
 #include <string>
 #include <sstream>
 #include <memory>
+#include <cassert>
+#include "util/log.h"
 #include "grid_node.h"
+#include "grid_layout.h"
 
-// This is used to hold grid nodes for quick indexing.
+// This is used to hold grid nodes for quick indexing. Nodes are stored in the
+// order of the layout. Nodes keep cell ids, so maps should be at most
+// kMaxCellIdSide cells a side.
 
 namespace fudge {
 
-template<typename CostType>
+template<typename CostType, typename Layout = RowMajorLayout>
 class GridNodeArray {
 public:
-  explicit GridNodeArray(int w, int h):w_(w), h_(h) {
+  using Node = GridNode<CostType>;
+
+public:
+  explicit GridNodeArray(int w, int h):w_(w), h_(h), layout_(w, h) {
+    if (!fits_cell_ids(w, h))
+      ERROR("Map of %dx%d is too large for cell ids.", w, h);
+    assert(fits_cell_ids(w, h));
     reset();
   }
 
@@ -25,17 +36,16 @@ public:
 
 public:
   void reset() {
-    array_.reset(new GridNode<CostType>[h_*w_]);
+    array_.reset(new Node[layout_.size()]);
     for (int i=0; i < h_; i++) {
       for (int j=0; j < w_; j++) {
-          node(Coord(j, i))->x(j);
-          node(Coord(j, i))->y(i);
+          node(Coord(j, i))->c(Coord(j, i));
       }
     }
   }
 
-  GridNode<CostType> *node(Coord coord) const{
-    return &array_.get()[coord.second * w_ + coord.first];
+  Node *node(Coord coord) const{
+    return &array_.get()[layout_.index(coord)];
   }
 
   bool off(Coord coord) const {
@@ -47,7 +57,8 @@ public:
   }
 
 private:
-  std::unique_ptr<GridNode<CostType>> array_ = nullptr;
+  Layout layout_;
+  std::unique_ptr<Node[]> array_ = nullptr;
 };
 
 }
@@ -0,0 +1,302 @@
+#ifndef FUDGE_HDA_STAR_SEARCH_H_
+#define FUDGE_HDA_STAR_SEARCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "edge.h"
+
+// Hash distributed A* on position maps. Each thread owns a copy of the map
+// given, with its own open list and explored nodes, and each node is owned by
+// the thread picked by its hash. A thread expands its own nodes and sends the
+// neighbors owned by others in batches. A batch is pushed to a lock free stack
+// of the receiver, which takes all batches at once, so no thread ever waits
+// for another.
+//
+// Once a goal is found, nodes of no lower cost are dropped, and the search
+// goes on until no thread has anything left, which keeps the path optimal if
+// the heuristic is admissible. The map should be a PositionMap, whose
+// explored nodes are used to follow the path back across threads.
+
+namespace fudge {
+
+template <typename MapType, typename Heuristic>
+class HdaStarSearch {
+public:
+  using NodeType = typename MapType::Node;
+  using CostType = typename MapType::Cost;
+  using HashType = typename MapType::Hash;
+
+public:
+  HdaStarSearch(const MapType &map, Heuristic heuristic, int threads)
+    : heuristic_(heuristic), threads_(std::max(threads, 1)) {
+    for (int i = 0; i < threads_; i++)
+      workers_.emplace_back(new Worker(map));
+  };
+  virtual ~HdaStarSearch() {
+    for (Worker *w : workers_)
+      delete w;
+  };
+
+  HdaStarSearch(const HdaStarSearch &) = delete;
+  HdaStarSearch &operator =(const HdaStarSearch &) = delete;
+
+public:
+  static constexpr std::size_t kBatchSize = 64;
+
+public:
+  // Return the path from the goal back to the start, as astar_search, or an
+  // empty path if there's none.
+  std::vector<NodeType> search(const NodeType &start, const NodeType &goal) {
+    goal_ = goal;
+    for (Worker *w : workers_)
+      w->expanded_ = 0;
+    best_cost_ = std::numeric_limits<CostType>::max();
+    found_ = false;
+    state_ = 0;
+
+    // The start is sent as a message, so that its owner picks it up.
+    state_.fetch_add(kActive * threads_ + 1);
+    workers_[owner(start.hash())]->inbox_.push(
+        new Batch {{Message {start, start, 0}}, nullptr});
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threads_; i++)
+      threads.emplace_back(&HdaStarSearch::run, this, i);
+    for (auto &t : threads)
+      t.join();
+
+    if (!found_)
+      return std::vector<NodeType>();
+
+    // Follow parents back through the maps owning them.
+    std::vector<NodeType> path;
+    NodeType p = best_goal_;
+    while (p.parent_ != p.hash()) {
+      path.push_back(p);
+      p = workers_[owner(p.parent_)]->map_.map_.at(p.parent_);
+    }
+    path.push_back(p);
+    return path;
+  }
+
+  // Map of a thread, with its explored nodes and stats.
+  const MapType &map(int thread) const {
+    return workers_[thread]->map_;
+  }
+
+  int threads() const {
+    return threads_;
+  }
+
+  // Nodes expanded by all threads. Nodes taken out of the open lists but
+  // dropped for costing no less than the goal found aren't counted.
+  std::size_t nodes_expanded() const {
+    std::size_t n = 0;
+    for (const Worker *w : workers_)
+      n += w->expanded_;
+    return n;
+  }
+
+private:
+  // Count of active threads in the upper 32 bits of state_, and count of
+  // messages sent but not taken in the lower bits. A thread goes active and
+  // takes messages in a single update, so the search is over once it's 0.
+  static constexpr int64_t kActive = int64_t(1) << 32;
+
+  struct Message {
+    NodeType node;
+    NodeType parent;
+    CostType g;
+  };
+
+  struct Batch {
+    std::vector<Message> messages;
+    Batch *next;
+  };
+
+  // A stack of batches pushed by any thread and taken by one.
+  class Inbox {
+  public:
+    ~Inbox() {
+      Batch *b = take();
+      while (b) {
+        Batch *next = b->next;
+        delete b;
+        b = next;
+      }
+    }
+
+  public:
+    void push(Batch *b) {
+      b->next = head_.load(std::memory_order_relaxed);
+      while (!head_.compare_exchange_weak(b->next, b,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+    }
+
+    Batch *take() {
+      return head_.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    bool is_empty() const {
+      return head_.load(std::memory_order_relaxed) == nullptr;
+    }
+
+  private:
+    std::atomic<Batch*> head_ {nullptr};
+  };
+
+  struct Worker {
+    explicit Worker(const MapType &map) : map_(map) {};
+
+    MapType map_;
+    Inbox inbox_;
+    std::size_t expanded_ = 0;
+  };
+
+  Heuristic heuristic_;
+  int threads_ = 1;
+  std::vector<Worker*> workers_;
+  NodeType goal_;
+  std::atomic<int64_t> state_ {0};
+  std::atomic<CostType> best_cost_ {0};
+  std::mutex best_mutex_;   // Guards best_goal_ and found_.
+  NodeType best_goal_;
+  bool found_ = false;
+
+private:
+  int owner(const HashType &h) const {
+    uint64_t x = std::hash<HashType>()(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x % threads_;
+  }
+
+  void run(int id) {
+    Worker &self = *workers_[id];
+    MapType &map = self.map_;
+    Heuristic heuristic = heuristic_;
+    std::vector<std::vector<Message>> outbox(threads_);
+    std::size_t taken = 0;
+
+    while (true) {
+      receive(self, heuristic);
+
+      if (map.open_node_available()) {
+        expand(id, heuristic, outbox);
+        // Send batches not filled up now and then, so others don't starve.
+        if (++taken % kBatchSize == 0) {
+          for (int i = 0; i < threads_; i++)
+            send(i, outbox[i]);
+        }
+        continue;
+      }
+
+      // Nothing left here. Send what's kept, and wait for messages or for
+      // the others to run out too.
+      for (int i = 0; i < threads_; i++)
+        send(i, outbox[i]);
+      if (!self.inbox_.is_empty())
+        continue;
+
+      state_.fetch_sub(kActive);
+      while (true) {
+        if (state_.load() == 0)
+          return;
+        if (!self.inbox_.is_empty())
+          break;
+        std::this_thread::yield();
+      }
+      state_.fetch_add(kActive);
+    }
+  }
+
+  // Open or update nodes sent to this thread.
+  void receive(Worker &self, Heuristic &heuristic) {
+    if (self.inbox_.is_empty())
+      return;
+    Batch *b = self.inbox_.take();
+    while (b) {
+      for (const Message &m : b->messages)
+        relax(self.map_, heuristic, m.node, m.parent, m.g);
+      state_.fetch_sub(b->messages.size());
+      Batch *next = b->next;
+      delete b;
+      b = next;
+    }
+  }
+
+  void relax(MapType &map, Heuristic &heuristic, const NodeType &n,
+             const NodeType &p, CostType g) {
+    const CostType h = heuristic(n, goal_);
+    if (!map.cost_less(g + h, best_cost_.load(std::memory_order_relaxed)))
+      return;
+
+    if (map.is_node_unexplored(n)) {
+      map.open_node(n, g, h, p);
+    } else if (map.cost_less(g, map.current_cost(n))) {
+      if (map.is_node_open(n))
+        map.increase_node_priority(n, g, h, p);
+      else
+        map.reopen_node(n, g, h, p);
+    }
+  }
+
+  void expand(int id, Heuristic &heuristic,
+              std::vector<std::vector<Message>> &outbox) {
+    Worker &self = *workers_[id];
+    MapType &map = self.map_;
+    const NodeType top = map.take_out_top_node();
+    const CostType g = map.current_cost(top);
+    if (!map.cost_less(g + heuristic(top, goal_), best_cost_.load()))
+      return;
+
+    if (map.nodes_equal(top, goal_)) {
+      std::lock_guard<std::mutex> lock(best_mutex_);
+      if (map.cost_less(g, best_cost_.load())) {
+        best_cost_.store(g);
+        best_goal_ = map.map_.at(top.hash());
+        found_ = true;
+      }
+      return;
+    }
+
+    self.expanded_++;
+    for (const auto &edge : map.edges(top)) {
+      const int i = owner(edge.to_.hash());
+      if (i == id) {
+        relax(map, heuristic, edge.to_, top, g + edge.cost_);
+      } else {
+        outbox[i].push_back(Message {edge.to_, top, g + edge.cost_});
+        if (outbox[i].size() >= kBatchSize)
+          send(i, outbox[i]);
+      }
+    }
+  }
+
+  void send(int i, std::vector<Message> &messages) {
+    if (messages.empty())
+      return;
+    // Counted before pushed, so the receiver never takes it uncounted.
+    state_.fetch_add(messages.size());
+    Batch *b = new Batch {std::vector<Message>(), nullptr};
+    b->messages.swap(messages);
+    workers_[i]->inbox_.push(b);
+  }
+};
+
+template <typename MapType, typename Heuristic>
+constexpr std::size_t HdaStarSearch<MapType, Heuristic>::kBatchSize;
+template <typename MapType, typename Heuristic>
+constexpr int64_t HdaStarSearch<MapType, Heuristic>::kActive;
+
+}
+
+#endif /* FUDGE_HDA_STAR_SEARCH_H_ */
@@ -20,7 +20,7 @@ class HotQueue
     : public PriorityQueue<ElementType, PriorityType>{
 public:
   HotQueue() = default;
-  HotQueue(PriorityType kc) : kc_(kc) {};
+  HotQueue(double kc) : kc_(kc) {};
   virtual ~HotQueue() = default;
 
 public:
@@ -0,0 +1,260 @@
+#ifndef FUDGE_IDA_STAR_SEARCH_H_
+#define FUDGE_IDA_STAR_SEARCH_H_
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "map.h"
+#include "edge.h"
+
+// Iterative deepening A*. It searches depth first with a bound on the cost
+// g + h, raising the bound to the least cost exceeding it after each
+// iteration. Only the current path is kept, so memory is O(depth), at the
+// price of searching again the nodes of earlier iterations.
+//
+// IdaStarSearch works on a domain which moves a single state in place:
+//
+//   using State, Move, Cost
+//   void moves(const State &s, std::vector<Move> &ms)  Append legal moves.
+//   Cost apply(State &s, const Move &m)   Make the move, return its cost.
+//   void undo(State &s, const Move &m)    Take back the move.
+//   bool reverses(const Move &m, const Move &last)  If m undoes last.
+//   bool nodes_equal(const State &s0, const State &s1)
+//   uint64_t hash(const State &s)         Used by the transposition table.
+//
+// Moves reversing the last one are never tried. A transposition table of a
+// fixed size could be given to cut paths reaching a state at no lower cost
+// than before in the same iteration. States of equal hash are taken as the
+// same state there, so the hash should be exact, e.g. a packed position.
+
+namespace fudge {
+
+template <typename Domain, typename Heuristic>
+class IdaStarSearch {
+public:
+  using State = typename Domain::State;
+  using Move = typename Domain::Move;
+  using Cost = typename Domain::Cost;
+
+public:
+  // The table holds up to @table_size states, rounded up to a power of 2.
+  // No table is used if it's 0.
+  IdaStarSearch(Domain &domain, Heuristic heuristic,
+                std::size_t table_size = 0)
+    : domain_(domain), heuristic_(heuristic) {
+    if (table_size > 0) {
+      std::size_t n = 1;
+      while (n < table_size)
+        n <<= 1;
+      table_.assign(n, Entry());
+      mask_ = n - 1;
+    }
+  };
+  virtual ~IdaStarSearch() = default;
+
+public:
+  // Return true if a path is found, after which moves() and path() give it.
+  // The search gives up once the bound exceeds @max_cost, as it may not end
+  // otherwise if the goal isn't reachable.
+  bool search(const State &start, const State &goal,
+              Cost max_cost = kInfinity) {
+    start_ = start;
+    state_ = start;
+    goal_ = goal;
+    moves_.clear();
+    nodes_expanded_ = 0;
+    iterations_ = 0;
+
+    Cost bound = heuristic_(state_, goal_);
+    while (true) {
+      iterations_++;
+      next_bound_ = kInfinity;
+      if (dfs(0, bound))
+        return true;
+      if (next_bound_ == kInfinity || next_bound_ > max_cost)
+        return false; // No state left, or none within the cost.
+      bound = next_bound_;
+    }
+  }
+
+  // Moves from the start to the goal.
+  const std::vector<Move> &moves() const {
+    return moves_;
+  }
+
+  // Return the path found, from the goal back to the start as astar_search.
+  std::vector<State> path() const {
+    std::vector<State> states {start_};
+    State s = start_;
+    for (const Move &m : moves_) {
+      domain_.apply(s, m);
+      states.push_back(s);
+    }
+    return std::vector<State>(states.rbegin(), states.rend());
+  }
+
+  Cost cost() const {
+    Cost c = 0;
+    State s = start_;
+    for (const Move &m : moves_)
+      c += domain_.apply(s, m);
+    return c;
+  }
+
+  uint64_t nodes_expanded() const {
+    return nodes_expanded_;
+  }
+
+  int iterations() const {
+    return iterations_;
+  }
+
+private:
+  static constexpr Cost kInfinity = std::numeric_limits<Cost>::max();
+
+  struct Entry {
+    uint64_t key = 0;
+    Cost g = 0;
+    int iteration = 0; // Entries of earlier iterations are empty.
+  };
+
+  Domain &domain_;
+  Heuristic heuristic_;
+  State start_;
+  State state_;
+  State goal_;
+  std::vector<Move> moves_;
+  std::deque<std::vector<Move>> successors_; // Moves to try at each depth.
+  std::vector<Entry> table_;
+  std::size_t mask_ = 0;
+  Cost next_bound_ = 0;
+  uint64_t nodes_expanded_ = 0;
+  int iterations_ = 0;
+
+private:
+  bool dfs(Cost g, Cost bound) {
+    const Cost f = g + heuristic_(state_, goal_);
+    if (f > bound) {
+      if (f < next_bound_)
+        next_bound_ = f;
+      return false;
+    }
+    if (domain_.nodes_equal(state_, goal_))
+      return true;
+    if (!table_.empty() && !visit(g))
+      return false;
+    nodes_expanded_++;
+
+    // Deeper calls only append, so the vector of this depth stays in place.
+    const std::size_t depth = moves_.size();
+    if (depth == successors_.size())
+      successors_.emplace_back();
+    std::vector<Move> &ms = successors_[depth];
+    ms.clear();
+    domain_.moves(state_, ms);
+
+    for (const Move &m : ms) {
+      if (depth > 0 && domain_.reverses(m, moves_.back()))
+        continue;
+      const Cost c = domain_.apply(state_, m);
+      moves_.push_back(m);
+      if (dfs(g + c, bound))
+        return true;
+      moves_.pop_back();
+      domain_.undo(state_, m);
+    }
+    return false;
+  }
+
+  // Record the cost of the current state. Return false if it has been
+  // reached at no higher cost in this iteration.
+  bool visit(Cost g) {
+    uint64_t key = domain_.hash(state_);
+    uint64_t h = key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    Entry &e = table_[h & mask_];
+    if (e.iteration == iterations_ && e.key == key) {
+      if (!(g < e.g))
+        return false;
+      e.g = g;
+      return true;
+    }
+    e.key = key;
+    e.g = g;
+    e.iteration = iterations_;
+    return true;
+  }
+};
+
+template <typename Domain, typename Heuristic>
+constexpr typename Domain::Cost IdaStarSearch<Domain, Heuristic>::kInfinity;
+
+// Iterative deepening A* on a map, for maps not moving states in place.
+// Neighbors come from edges() as in astar_search, and nodes already on the
+// current path are skipped. The node state of the map isn't used, so memory is
+// O(depth) unless edges() itself stores nodes.
+template <typename NodeType, typename CostType, typename Heuristic>
+std::vector<NodeType> ida_star_search(Map<NodeType, CostType> &map,
+                                      const NodeType &start,
+                                      const NodeType &goal,
+                                      Heuristic heuristic) {
+  struct Searcher {
+    Map<NodeType, CostType> &map;
+    const NodeType &goal;
+    Heuristic &heuristic;
+    std::vector<NodeType> path;
+    CostType next_bound;
+
+    bool dfs(CostType g, CostType bound) {
+      const NodeType n = path.back();
+      const CostType f = g + heuristic(n, goal);
+      if (map.cost_greater(f, bound)) {
+        if (map.cost_less(f, next_bound))
+          next_bound = f;
+        return false;
+      }
+      if (map.nodes_equal(n, goal))
+        return true;
+
+      for (const auto &edge : map.edges(n)) {
+        bool on_path = false;
+        for (const NodeType &p : path) {
+          if (map.nodes_equal(p, edge.to_)) {
+            on_path = true;
+            break;
+          }
+        }
+        if (on_path)
+          continue;
+
+        path.push_back(edge.to_);
+        if (dfs(g + edge.cost_, bound))
+          return true;
+        path.pop_back();
+      }
+      return false;
+    }
+  };
+
+  const CostType infinity = std::numeric_limits<CostType>::max();
+  Searcher searcher {map, goal, heuristic, {start}, infinity};
+  CostType bound = heuristic(start, goal);
+  while (true) {
+    searcher.next_bound = infinity;
+    if (searcher.dfs(0, bound)) {
+      // Return the path from the goal back to the start, as astar_search.
+      return std::vector<NodeType>(searcher.path.rbegin(),
+                                   searcher.path.rend());
+    }
+    if (searcher.next_bound == infinity)
+      return std::vector<NodeType>(); // No path found.
+    bound = searcher.next_bound;
+  }
+}
+
+}
+
+#endif /* FUDGE_IDA_STAR_SEARCH_H_ */
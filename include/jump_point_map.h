@@ -12,6 +12,8 @@
 // method to return jump points collected. Additionally we have to utilize
 // initialize() call to mark the goal node on the map so that we could make it a
 // jump point.
+// Obstacles are looked up in a passability bitmap of cells with weights not
+// above 1, so call update() after editing weights of the matrix in place.
 
 namespace fudge {
 
@@ -23,7 +25,9 @@ template <typename CostType>
 class JumpPointMap : public GridMap<CostType> {
 public:
   JumpPointMap(int w, int h, std::vector<CostType> &matrix)
-      : GridMap<CostType>(w, h, matrix) {};
+      : GridMap<CostType>(w, h, matrix) {
+    this->use_passability_bitmap(1);
+  };
   virtual ~JumpPointMap() = default;
 
 public:
@@ -34,7 +38,7 @@ public:
 
     // Search and add jump points at all directions for start node.
     // For others, only search at necessary directions.
-    if (this->node(n)->parent_->c_ == n) {
+    if (this->node(n)->parent_->id_ == cell_id(n)) {
       const std::vector<Coord> &&coords = this->coord_8_neighbors(n);
       for (auto c : coords) {
         push_jump_point(es, c.first, c.second, n);
@@ -143,9 +147,10 @@ protected:
 
 protected:
   // Determine if a node is passable. Note we ignore the weight of the node
-  // because Jump Point algorithm does not work on weighted map.
-  bool is_passable(int x, int y) {
-    return this->vertex_matrix_.is_passable(Coord(x, y), 1);
+  // because Jump Point algorithm does not work on weighted map, so cells with
+  // weights above 1 are obstacles in the bitmap.
+  bool is_passable(int x, int y) const {
+    return this->passability_->is_passable(Coord(x, y));
   }
 
   // Helper to push a jump point found to the container.
@@ -1,38 +1,202 @@
 #ifndef FUDGE_LOAD_MATRIX_H_
 #define FUDGE_LOAD_MATRIX_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <vector>
-#include <fstream>
 #include "util/log.h"
+#include "util/mapped_file.h"
+
+// Load a matrix of comma separated values. Each line of the file is a row of
+// the matrix. Spaces and a trailing comma at the end of a row are allowed.
+// The file is memory mapped and parsed in place.
 
 namespace fudge {
 
+// Parse an integer in [p, end). Return the end of the number, or nullptr if
+// there's no valid number.
 template <typename WeightType>
-static std::vector<WeightType> load_matrix(const std::string &filename) {
-  std::vector<WeightType> v;
+static const char *parse_number(const char *p, const char *end, WeightType &v,
+                                std::true_type /* is_integer */) {
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  const char *digits = p;
+  uint64_t u = 0;
+  while (p < end && *p >= '0' && *p <= '9' && p - digits < 19)
+    u = u * 10 + (*p++ - '0');
+  if (p == digits || (p < end && *p >= '0' && *p <= '9'))
+    return nullptr; // No digit or too many digits.
+
+  int64_t i = negative ? -static_cast<int64_t>(u) : static_cast<int64_t>(u);
+  if (i < static_cast<int64_t>(std::numeric_limits<WeightType>::min())
+      || i > static_cast<int64_t>(std::numeric_limits<WeightType>::max()))
+    return nullptr; // Out of range.
+  v = static_cast<WeightType>(i);
+  return p;
+}
+
+// Parse a floating point number in [p, end). Return the end of the number,
+// or nullptr if there's no valid number. Numbers with up to 15 significant
+// digits and a small exponent are converted exactly without strtod().
+template <typename WeightType>
+static const char *parse_number(const char *p, const char *end, WeightType &v,
+                                std::false_type /* is_integer */) {
+  static constexpr double kPowers[] {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
 
-  std::ifstream ifs(filename);
-  if(ifs.is_open()) {
-    while(ifs.good()) {
-      std::string line;
-      getline(ifs, line);
-      std::istringstream ss(line);
-      std::string s;
-      while (getline(ss, s, ',' )
-          && s.find_first_not_of(" \t\r\n") != s.npos ) {
-        std::istringstream is(s);
-        WeightType i;
-        is >> i;
-        v.push_back(i);
+  const char *begin = p;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any_digit = false;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p, any_digit = true) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits += mantissa != 0;
+    } else {
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p, any_digit = true) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa != 0;
+        --exponent;
       }
     }
+  }
+  if (!any_digit)
+    return nullptr;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    bool negative_exponent = false;
+    if (q < end && (*q == '-' || *q == '+'))
+      negative_exponent = *q++ == '-';
+    if (q == end || *q < '0' || *q > '9')
+      return nullptr;
+    int e = 0;
+    for (; q < end && *q >= '0' && *q <= '9'; ++q)
+      e = std::min(e * 10 + (*q - '0'), 9999);
+    exponent += negative_exponent ? -e : e;
+    p = q;
+  }
+
+  double d = 0;
+  if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+    d = static_cast<double>(mantissa);
+    d = exponent < 0 ? d / kPowers[-exponent] : d * kPowers[exponent];
+    d = negative ? -d : d;
   } else {
-    ERROR("File not found.\n");
+    // Rare. Let strtod() round it correctly.
+    std::string s(begin, p);
+    d = std::strtod(s.c_str(), nullptr);
+  }
+  v = static_cast<WeightType>(d);
+  return p;
+}
+
+// Load a matrix and detect its width and height. The width is the count of
+// values in each row. Blank lines are ignored. If the file is missing or
+// malformed, an error is logged, and an empty matrix with 0 width and height
+// is returned.
+template <typename WeightType>
+static std::vector<WeightType> load_matrix(const std::string &filename,
+                                           int &width, int &height) {
+  std::vector<WeightType> v;
+  width = 0;
+  height = 0;
+
+  MappedFile file(filename);
+  if (!file.is_open()) {
+    ERROR("File not found: %s", filename.c_str());
+    return v;
+  }
+
+  const char *p = file.data();
+  const char *end = p + file.size();
+  v.reserve(std::count(p, end, ',') + 1);
+
+  for (int line = 1; p < end; ++line) {
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    if (eol == nullptr)
+      eol = end;
+
+    int count = 0;
+    const char *q = p;
+    while (true) {
+      while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r'))
+        ++q;
+      if (q == eol)
+        break;
+
+      WeightType value;
+      const char *next = parse_number(q, eol, value,
+          std::integral_constant<bool,
+              std::numeric_limits<WeightType>::is_integer>());
+      if (next == nullptr) {
+        ERROR("%s:%d:%d: Malformed number.", filename.c_str(), line,
+              static_cast<int>(q - p + 1));
+        v.clear();
+        width = height = 0;
+        return v;
+      }
+      v.push_back(value);
+      ++count;
+
+      q = next;
+      while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r'))
+        ++q;
+      if (q == eol)
+        break;
+      if (*q != ',') {
+        ERROR("%s:%d:%d: Expected ',' but found '%c'.", filename.c_str(),
+              line, static_cast<int>(q - p + 1), *q);
+        v.clear();
+        width = height = 0;
+        return v;
+      }
+      ++q;
+    }
+
+    if (count > 0) {
+      if (width == 0) {
+        width = count;
+      } else if (count != width) {
+        ERROR("%s:%d: Row has %d values but %d are expected.",
+              filename.c_str(), line, count, width);
+        v.clear();
+        width = height = 0;
+        return v;
+      }
+      ++height;
+    }
+    p = eol + 1;
   }
   return v;
 }
 
+template <typename WeightType>
+static std::vector<WeightType> load_matrix(const std::string &filename) {
+  int width = 0;
+  int height = 0;
+  return load_matrix<WeightType>(filename, width, height);
+}
+
 }
 
 #endif /* FUDGE_LOAD_MATRIX_H_ */
@@ -0,0 +1,28 @@
+#ifndef FUDGE_MORTON_H_
+#define FUDGE_MORTON_H_
+
+#include <cstdint>
+
+// Helpers of Morton (Z-order) codes. Nodes close to each other on the grid
+// mostly get close codes, which keeps them close in memory.
+
+namespace fudge {
+
+// Spread the lower 16 bits so that there's a zero bit between each two bits.
+inline uint32_t morton_spread(uint32_t v) {
+  v &= 0x0000FFFF;
+  v = (v | (v << 8)) & 0x00FF00FF;
+  v = (v | (v << 4)) & 0x0F0F0F0F;
+  v = (v | (v << 2)) & 0x33333333;
+  v = (v | (v << 1)) & 0x55555555;
+  return v;
+}
+
+// Interleave the bits of x and y. Both should be less than 65536.
+inline uint32_t morton_code(uint32_t x, uint32_t y) {
+  return morton_spread(x) | (morton_spread(y) << 1);
+}
+
+}
+
+#endif /* FUDGE_MORTON_H_ */
@@ -0,0 +1,156 @@
+#ifndef FUDGE_MOVING_AI_H_
+#define FUDGE_MOVING_AI_H_
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "util/log.h"
+#include "grid_node.h"
+
+// This implements parsers of the grid benchmark formats from the Moving AI
+// lab: ".map" terrain files and ".scen" scenario files.
+//
+// Terrain is converted to weights of VertexMatrix. '.' and 'G' are passable
+// ground. 'S' (swamp) is passable with the swamp weight. '@', 'O' and 'T'
+// (trees) are obstacles. 'W' (water) is only passable from water in the
+// benchmarks, which a VertexMatrix could not express, so it is an obstacle.
+
+namespace fudge {
+
+// Return the weight of a terrain character. Unknown characters are -2.
+template <typename WeightType>
+WeightType moving_ai_weight(char c, WeightType swamp_weight = 1) {
+  switch (c) {
+  case '.':
+  case 'G':
+    return 1;
+  case 'S':
+    return swamp_weight;
+  case '@':
+  case 'O':
+  case 'T':
+  case 'W':
+    return -1;
+  default:
+    return -2;
+  }
+}
+
+// Load a ".map" file. If the file is missing or malformed, an error is logged,
+// and an empty matrix with 0 width and height is returned.
+template <typename WeightType>
+std::vector<WeightType> load_moving_ai_map(const std::string &filename,
+                                           int &width, int &height,
+                                           WeightType swamp_weight = 1) {
+  std::vector<WeightType> matrix;
+  width = 0;
+  height = 0;
+
+  std::ifstream ifs(filename);
+  if (!ifs.is_open()) {
+    ERROR("File not found: %s", filename.c_str());
+    return matrix;
+  }
+
+  // Header: type, height, width, and the "map" keyword.
+  std::string key;
+  int w = -1;
+  int h = -1;
+  while (ifs >> key && key != "map") {
+    if (key == "height")
+      ifs >> h;
+    else if (key == "width")
+      ifs >> w;
+    else if (key == "type")
+      ifs >> key;
+  }
+  if (key != "map" || w <= 0 || h <= 0) {
+    ERROR("%s: Invalid map header.", filename.c_str());
+    return matrix;
+  }
+
+  matrix.reserve(static_cast<std::size_t>(w) * h);
+  std::string line;
+  std::getline(ifs, line); // Rest of the "map" line.
+  for (int y = 0; y < h; y++) {
+    if (!std::getline(ifs, line)) {
+      ERROR("%s: Expected %d rows but found %d.", filename.c_str(), h, y);
+      matrix.clear();
+      return matrix;
+    }
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (static_cast<int>(line.size()) != w) {
+      ERROR("%s: Row %d has %zu columns but %d are expected.",
+            filename.c_str(), y, line.size(), w);
+      matrix.clear();
+      return matrix;
+    }
+    for (int x = 0; x < w; x++) {
+      WeightType v = moving_ai_weight<WeightType>(line[x], swamp_weight);
+      if (v == -2) {
+        ERROR("%s: Unknown terrain '%c' at (%d,%d).", filename.c_str(),
+              line[x], x, y);
+        matrix.clear();
+        return matrix;
+      }
+      matrix.push_back(v);
+    }
+  }
+
+  width = w;
+  height = h;
+  return matrix;
+}
+
+// A problem of a ".scen" file.
+class MovingAIScenario {
+public:
+  int bucket_ = 0;
+  std::string map_;          // Map file name, relative to the benchmark.
+  int map_width_ = 0;
+  int map_height_ = 0;
+  Coord start_ = {-1, -1};
+  Coord goal_ = {-1, -1};
+  double optimal_length_ = 0;  // Octile distance without corner cutting.
+};
+
+// Load a ".scen" file. If the file is missing or malformed, an error is
+// logged, and an empty list is returned.
+inline std::vector<MovingAIScenario> load_moving_ai_scenarios(
+    const std::string &filename) {
+  std::vector<MovingAIScenario> scenarios;
+
+  std::ifstream ifs(filename);
+  if (!ifs.is_open()) {
+    ERROR("File not found: %s", filename.c_str());
+    return scenarios;
+  }
+
+  std::string line;
+  int n = 0;
+  while (std::getline(ifs, line)) {
+    ++n;
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    if (n == 1 && line.compare(0, 7, "version") == 0)
+      continue;
+
+    std::istringstream ss(line);
+    MovingAIScenario s;
+    if (!(ss >> s.bucket_ >> s.map_ >> s.map_width_ >> s.map_height_
+             >> s.start_.first >> s.start_.second
+             >> s.goal_.first >> s.goal_.second >> s.optimal_length_)) {
+      ERROR("%s:%d: Malformed scenario.", filename.c_str(), n);
+      scenarios.clear();
+      return scenarios;
+    }
+    scenarios.push_back(s);
+  }
+  return scenarios;
+}
+
+}
+
+#endif /* FUDGE_MOVING_AI_H_ */
@@ -0,0 +1,83 @@
+#ifndef FUDGE_PASSABILITY_BITMAP_H_
+#define FUDGE_PASSABILITY_BITMAP_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// This keeps one bit per cell telling if the cell is passable, so that
+// expansions don't have to read the weights only to find obstacles. The
+// bitmap of a 2048x2048 map takes 512KB.
+//
+// Cells are surrounded by a border of one impassable cell. Neighbors of any
+// cell on the map could be checked without testing if they are off the map.
+// Coordinates farther off the map than the border must not be checked.
+
+namespace fudge {
+
+class PassabilityBitmap {
+public:
+  // All cells are impassable at first.
+  PassabilityBitmap(int w, int h)
+    : width_(w), height_(h), stride_(w + 2),
+      bits_((static_cast<std::size_t>(w + 2) * (h + 2) + 63) / 64, 0) {};
+
+  // Take cells passable by matrix.is_passable(coord), like a VertexMatrix.
+  template <typename Matrix>
+  explicit PassabilityBitmap(const Matrix &matrix)
+    : PassabilityBitmap(matrix.width_, matrix.height_) {
+    for (int y = 0; y < height_; y++) {
+      for (int x = 0; x < width_; x++)
+        set(std::make_pair(x, y), matrix.is_passable(std::make_pair(x, y)));
+    }
+  }
+
+  // Take cells with weights not above the threshold.
+  template <typename Matrix, typename WeightType>
+  PassabilityBitmap(const Matrix &matrix, WeightType threshold)
+    : PassabilityBitmap(matrix.width_, matrix.height_) {
+    for (int y = 0; y < height_; y++) {
+      for (int x = 0; x < width_; x++)
+        set(std::make_pair(x, y),
+            matrix.is_passable(std::make_pair(x, y), threshold));
+    }
+  }
+
+  virtual ~PassabilityBitmap() = default;
+
+public:
+  const int width_;
+  const int height_;
+
+public:
+  bool is_passable(const std::pair<int,int> &c) const {
+    const std::size_t i = index(c);
+    return (bits_[i >> 6] >> (i & 63)) & 1;
+  }
+
+  // Cells of the border are always impassable, so they should not be set.
+  void set(const std::pair<int,int> &c, bool passable) {
+    const std::size_t i = index(c);
+    if (passable)
+      bits_[i >> 6] |= uint64_t(1) << (i & 63);
+    else
+      bits_[i >> 6] &= ~(uint64_t(1) << (i & 63));
+  }
+
+  std::size_t memory_usage() const {
+    return bits_.size() * sizeof(uint64_t);
+  }
+
+private:
+  const int stride_;
+  std::vector<uint64_t> bits_;
+
+private:
+  std::size_t index(const std::pair<int,int> &c) const {
+    return static_cast<std::size_t>(c.second + 1) * stride_ + c.first + 1;
+  }
+};
+
+}
+
+#endif /* FUDGE_PASSABILITY_BITMAP_H_ */
@@ -0,0 +1,291 @@
+#ifndef FUDGE_PATH_DATABASE_H_
+#define FUDGE_PATH_DATABASE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util/log.h"
+#include "morton.h"
+#include "grid_dijkstra.h"
+
+// This implements a compressed path database (CPD) for a static grid map.
+// For every source node it keeps the first move on a shortest path to every
+// target node. Targets are laid out in Morton order, in which nearby targets
+// mostly share the same first move, and each row is run-length compressed.
+// A path is extracted without any search by following first moves.
+
+namespace fudge {
+
+template <typename CostType = double>
+class CompressedPathDatabase {
+public:
+  CompressedPathDatabase() = default;
+  virtual ~CompressedPathDatabase() = default;
+
+public:
+  // Build the database with edges of a GridMap with the same matrix. If
+  // threads is 0, the number of hardware threads is used.
+  void build(const VertexMatrix<CostType> &vertex_matrix,
+             bool enable_diagonal = true, unsigned int threads = 0) {
+    w_ = vertex_matrix.width_;
+    h_ = vertex_matrix.height_;
+    enable_diagonal_ = enable_diagonal;
+    index_cells(vertex_matrix);
+
+    const std::size_t n = cells_.size();
+    std::vector<std::vector<uint32_t>> rows(n);
+
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+      workers.push_back(std::thread([&]() {
+        std::vector<CostType> dist;
+        std::vector<unsigned char> moves;
+        std::size_t i;
+        while ((i = next++) < n) {
+          grid_dijkstra(vertex_matrix, cells_[i], enable_diagonal_, dist,
+                        &moves);
+          encode(i, moves, rows[i]);
+        }
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+
+    offsets_.assign(1, 0);
+    runs_.clear();
+    for (auto &row : rows) {
+      runs_.insert(runs_.end(), row.begin(), row.end());
+      offsets_.push_back(runs_.size());
+    }
+  }
+
+  // Return the index of the neighbor to move to (see kNeighborX and
+  // kNeighborY), or kNoMove if the target is unreachable.
+  unsigned char first_move(const Coord &from, const Coord &to) const {
+    if (!is_passable(from) || !is_passable(to) || from == to)
+      return kNoMove;
+
+    const uint32_t i = order_of(from);
+    const uint32_t key = (order_of(to) << kMoveBits) | kMoveMask;
+    const uint32_t *begin = &runs_[0] + offsets_[i];
+    const uint32_t *end = &runs_[0] + offsets_[i + 1];
+    const uint32_t *run = std::upper_bound(begin, end, key) - 1;
+    return (*run & kMoveMask) == kMoveMask ? kNoMove : *run & kMoveMask;
+  }
+
+  // Follow first moves from start to goal. The path is returned in the same
+  // order as GridMap::get_path(): from the goal back to the node next to the
+  // start. The path is empty if the goal is unreachable.
+  std::vector<Coord> path(const Coord &start, const Coord &goal) const {
+    std::vector<Coord> result;
+    Coord c = start;
+    while (c != goal && result.size() < cells_.size()) {
+      unsigned char k = first_move(c, goal);
+      if (k == kNoMove)
+        return std::vector<Coord>();
+      c = Coord(c.first + kNeighborX[k], c.second + kNeighborY[k]);
+      result.push_back(c);
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+  }
+
+  // Number of runs of all rows.
+  std::size_t runs() const {
+    return runs_.size();
+  }
+
+  std::size_t bytes() const {
+    return runs_.size() * sizeof(uint32_t)
+        + offsets_.size() * sizeof(uint32_t)
+        + order_.size() * sizeof(int32_t);
+  }
+
+public:
+  // Save the database to a binary file.
+  bool save(const std::string &filename) const {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open()) {
+      ERROR("Failed to open %s for writing.", filename.c_str());
+      return false;
+    }
+
+    const uint32_t n = cells_.size();
+    const uint32_t runs = runs_.size();
+    const uint8_t diagonal = enable_diagonal_ ? 1 : 0;
+    ofs.write(kMagic, sizeof(kMagic));
+    write(ofs, kVersion);
+    write(ofs, w_);
+    write(ofs, h_);
+    write(ofs, diagonal);
+    write(ofs, n);
+    write(ofs, runs);
+    ofs.write(reinterpret_cast<const char *>(order_.data()),
+              order_.size() * sizeof(int32_t));
+    ofs.write(reinterpret_cast<const char *>(offsets_.data()),
+              offsets_.size() * sizeof(uint32_t));
+    ofs.write(reinterpret_cast<const char *>(runs_.data()),
+              runs_.size() * sizeof(uint32_t));
+    return ofs.good();
+  }
+
+  // Load a database saved by save(). Return false if the file is invalid.
+  bool load(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+      ERROR("File not found: %s", filename.c_str());
+      return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t n = 0;
+    uint32_t runs = 0;
+    uint8_t diagonal = 0;
+    ifs.read(magic, sizeof(magic));
+    read(ifs, version);
+    if (!ifs.good() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0
+        || version != kVersion) {
+      ERROR("Invalid path database: %s", filename.c_str());
+      return false;
+    }
+
+    read(ifs, w_);
+    read(ifs, h_);
+    read(ifs, diagonal);
+    read(ifs, n);
+    read(ifs, runs);
+    if (!ifs.good() || w_ <= 0 || h_ <= 0
+        || n > static_cast<uint32_t>(w_ * h_)) {
+      ERROR("Invalid path database header: %s", filename.c_str());
+      return false;
+    }
+    enable_diagonal_ = diagonal != 0;
+
+    order_.resize(w_ * h_);
+    offsets_.resize(n + 1);
+    runs_.resize(runs);
+    ifs.read(reinterpret_cast<char *>(order_.data()),
+             order_.size() * sizeof(int32_t));
+    ifs.read(reinterpret_cast<char *>(offsets_.data()),
+             offsets_.size() * sizeof(uint32_t));
+    ifs.read(reinterpret_cast<char *>(runs_.data()),
+             runs_.size() * sizeof(uint32_t));
+    if (!ifs.good() || offsets_.back() != runs) {
+      ERROR("Truncated path database: %s", filename.c_str());
+      return false;
+    }
+
+    cells_.assign(n, Coord(-1, -1));
+    for (int i = 0; i < w_ * h_; i++) {
+      if (order_[i] >= static_cast<int32_t>(n)) {
+        ERROR("Invalid path database order: %s", filename.c_str());
+        return false;
+      }
+      if (order_[i] >= 0)
+        cells_[order_[i]] = Coord(i % w_, i / w_);
+    }
+    return true;
+  }
+
+private:
+  // Each run is encoded as (index of the first target << 4 | move).
+  static constexpr int kMoveBits = 4;
+  static constexpr uint32_t kMoveMask = (1 << kMoveBits) - 1;
+  static constexpr char kMagic[8] {'F', 'U', 'D', 'G', 'E', 'C', 'P', 'D'};
+  static constexpr uint32_t kVersion = 1;
+
+  int32_t w_ = 0;
+  int32_t h_ = 0;
+  bool enable_diagonal_ = true;
+  std::vector<Coord> cells_;       // Passable nodes in Morton order.
+  std::vector<int32_t> order_;     // Index of each node in cells_, or -1.
+  std::vector<uint32_t> offsets_;  // Offset of the first run of each source.
+  std::vector<uint32_t> runs_;     // Runs of all sources.
+
+private:
+  int cell_index(const Coord &c) const {
+    return c.second * w_ + c.first;
+  }
+
+  uint32_t order_of(const Coord &c) const {
+    return order_[cell_index(c)];
+  }
+
+  bool is_passable(const Coord &c) const {
+    return c.first >= 0 && c.first < w_ && c.second >= 0 && c.second < h_
+        && order_[cell_index(c)] >= 0;
+  }
+
+  // Lay passable nodes out in Morton order.
+  void index_cells(const VertexMatrix<CostType> &vertex_matrix) {
+    cells_.clear();
+    for (int y = 0; y < h_; y++)
+      for (int x = 0; x < w_; x++)
+        if (vertex_matrix.is_passable(Coord(x, y)))
+          cells_.push_back(Coord(x, y));
+
+    std::sort(cells_.begin(), cells_.end(),
+        [](const Coord &a, const Coord &b) {
+          return morton_code(a.first, a.second)
+              < morton_code(b.first, b.second);
+        });
+
+    order_.assign(w_ * h_, -1);
+    for (std::size_t i = 0; i < cells_.size(); i++)
+      order_[cell_index(cells_[i])] = i;
+  }
+
+  // Run-length encode first moves of the source in Morton order. The source
+  // itself matches any move so that it never starts a run.
+  void encode(std::size_t source, const std::vector<unsigned char> &moves,
+              std::vector<uint32_t> &row) const {
+    uint32_t last = kMoveMask + 1; // No run yet.
+    for (std::size_t i = 0; i < cells_.size(); i++) {
+      if (i == source && last <= kMoveMask)
+        continue;
+      unsigned char k = moves[cell_index(cells_[i])];
+      uint32_t move = k == kNoMove ? kMoveMask : k;
+      if (move != last) {
+        row.push_back((static_cast<uint32_t>(i) << kMoveBits) | move);
+        last = move;
+      }
+    }
+  }
+
+  template <typename T>
+  static void write(std::ofstream &ofs, const T &v) {
+    ofs.write(reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template <typename T>
+  static void read(std::ifstream &ifs, T &v) {
+    ifs.read(reinterpret_cast<char *>(&v), sizeof(T));
+  }
+};
+
+template <typename CostType>
+constexpr int CompressedPathDatabase<CostType>::kMoveBits;
+
+template <typename CostType>
+constexpr uint32_t CompressedPathDatabase<CostType>::kMoveMask;
+
+template <typename CostType>
+constexpr char CompressedPathDatabase<CostType>::kMagic[8];
+
+template <typename CostType>
+constexpr uint32_t CompressedPathDatabase<CostType>::kVersion;
+
+}
+
+#endif /* FUDGE_PATH_DATABASE_H_ */
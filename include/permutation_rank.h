@@ -0,0 +1,68 @@
+#ifndef FUDGE_PERMUTATION_RANK_H_
+#define FUDGE_PERMUTATION_RANK_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Lexicographic rank of permutations of 0..n-1, with n at most 16. The
+// permutation is packed into a 64-bit word, element i in the i-th nibble,
+// like PackedSlidingPosition. Ranks are dense in [0, n!), so a state space of
+// permutations could be indexed by an array without hashing.
+
+namespace fudge {
+
+constexpr uint64_t factorial(int n) {
+  return n <= 1 ? 1 : n * factorial(n - 1);
+}
+
+// Each digit of the Lehmer code counts the smaller elements not used yet.
+inline uint64_t permutation_rank(uint64_t packed, int n) {
+  uint64_t rank = 0;
+  uint32_t used = 0;
+  for (int i = 0; i < n; i++) {
+    const int t = (packed >> (i * 4)) & 0xF;
+    const int smaller = t - __builtin_popcount(used & ((1u << t) - 1));
+    rank = rank * (n - i) + smaller;
+    used |= 1u << t;
+  }
+  return rank;
+}
+
+inline uint64_t permutation_unrank(uint64_t rank, int n) {
+  int digits[16];
+  for (int i = n - 1; i >= 0; i--) {
+    digits[i] = rank % (n - i);
+    rank /= (n - i);
+  }
+
+  uint64_t packed = 0;
+  uint32_t unused = (1u << n) - 1;
+  for (int i = 0; i < n; i++) {
+    uint32_t u = unused;
+    for (int k = 0; k < digits[i]; k++)
+      u &= u - 1; // Drop the lowest unused elements.
+    const int t = __builtin_ctz(u);
+    packed |= static_cast<uint64_t>(t) << (i * 4);
+    unused &= ~(1u << t);
+  }
+  return packed;
+}
+
+// Ranker of packed permutations of kSize elements, for RankedMap.
+template <int kElements>
+struct PackedPermutationRank {
+  static_assert(kElements > 0 && kElements <= 16,
+                "A packed permutation has 1 to 16 elements.");
+  static constexpr std::size_t kSize = factorial(kElements);
+
+  std::size_t operator()(uint64_t packed) const {
+    return permutation_rank(packed, kElements);
+  }
+};
+
+template <int kElements>
+constexpr std::size_t PackedPermutationRank<kElements>::kSize;
+
+}
+
+#endif /* FUDGE_PERMUTATION_RANK_H_ */
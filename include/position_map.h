@@ -11,6 +11,7 @@
 #include "search_stats.h"
 #include "hot_queue.h"
 #include "binary_heap.h"
+#include "flat_hash_map.h"
 
 namespace fudge {
 
@@ -38,10 +39,53 @@ public:
   HashType parent_;
 };
 
+// The search state of a position, with hash() and to_string() given by
+// @Derived instead of virtual functions. Calls are bound at compile time and
+// may be inlined, and there's no vtable pointer, so a position of plain
+// members is trivially copyable. Nodes are equal if hashes are, unless
+// @Derived defines its own operator ==.
+template<typename Derived, typename CostType, typename HashType>
+class PositionNode {
+public:
+  bool operator == (const Derived &pos) const {
+    return static_cast<const Derived &>(*this).hash() == pos.hash();
+  }
+
+public:
+  int cost_ = 0;
+  int g_ = 0;
+  NodeState state_ = NodeState::unexplored;
+  HashType parent_;
+
+protected:
+  ~PositionNode() = default; // Not to be deleted through the base.
+};
+
+// The counterpart of Position without virtual functions, for positions made
+// of a vector of T.
+template<typename Derived, typename T, typename CostType, typename HashType>
+class StaticPosition : public PositionNode<Derived, CostType, HashType> {
+public:
+  StaticPosition(const std::vector<T> &pos): pos_(pos) {};
+  StaticPosition() {};
+
+public:
+  std::vector<T> pos_;
+};
+
 // This implements a position map for solving position based puzzles, in which
 // each position of the puzzle could be regarded as a searching node.
-template<typename T, typename NodeType, typename CostType, typename HashType>
+// Explored nodes are stored by hash in a std::map by default. A FlatHashMap
+// could be used instead, which is much faster for large searches. Nodes may
+// derive from Position or from PositionNode.
+template<typename T, typename NodeType, typename CostType, typename HashType,
+         typename Storage = std::map<HashType, NodeType>>
 class PositionMap : public Map<NodeType, int> {
+public:
+  using Node = NodeType;
+  using Cost = CostType;
+  using Hash = HashType;
+
 public:
   PositionMap() : open_list_(1) {};
   virtual ~PositionMap() = default;
@@ -70,8 +114,11 @@ public:
     return n0.hash() == n1.hash();
   }
 
+  // Positions are told apart by hash alone, so hashes should be exact, or
+  // keys comparing states, like ZobristKey. Keys of other states with the same
+  // hash code are counted as collisions in a FlatHashMap.
   virtual bool is_node_unexplored(const NodeType &n) const override {
-    return map_.find(n.hash()) == map_.end();
+    return map_.count(n.hash()) == 0;
   }
 
   virtual bool is_node_open(const NodeType &n) const override {
@@ -79,7 +126,7 @@ public:
   }
 
   virtual bool open_node_available() const override {
-    return !(open_list_.is_empty());
+    return !(open_list_.is_empty()) && open_count_ > stale_count_;
   }
 
   // Operations
@@ -91,6 +138,8 @@ public:
     nn.cost_ = g + h;
     nn.state_ = NodeState::open;
     open_list_.insert(nn);
+    open_count_++;
+    stats_.hash_collisions += count_collisions(map_, n.hash());
     map_[n.hash()] = nn;
     stats_.nodes_opened++;
     DEBUG("Node opened: %s, %d, %d", nn.to_string().c_str(), nn.g_, nn.cost_);
@@ -104,6 +153,7 @@ public:
 	  nn.cost_ = g + h;
 	  nn.state_ = NodeState::open;
 	  open_list_.insert(nn);
+	  open_count_++;
 	  map_[nn.hash()] = nn;
 	  stats_.nodes_opened++;
 	  DEBUG("Node reopened: %s, %d, %d", nn.to_string().c_str(), nn.g_, nn.cost_);
@@ -111,6 +161,12 @@ public:
 
   virtual NodeType take_out_top_node() override {
     NodeType n = open_list_.remove_front();
+    open_count_--;
+    while (is_stale(n)) {
+      stale_count_--;
+      n = open_list_.remove_front();
+      open_count_--;
+    }
     map_.at(n.hash()).state_ = NodeState::closed;
     stats_.nodes_closed++;
     DEBUG("Node closed: %s, %d, %d", nn.to_string().c_str(), nn.g_, nn.cost_);
@@ -119,11 +175,15 @@ public:
 
   virtual void increase_node_priority(const NodeType &n, CostType g, CostType h,
                                       const NodeType &p) override {
+    // The entry in the open list is left there as stale, rather than found
+    // and moved, which takes a linear search.
     NodeType &nn = map_.at(n.hash());
-    open_list_.increase_priority(nn, g + h);
     nn.parent_ = p.hash();
     nn.g_ = g;
     nn.cost_ = g + h;
+    open_list_.insert(nn);
+    open_count_++;
+    stale_count_++;
     stats_.nodes_priority_increased++;
     DEBUG("Node priority increased: %s, %d, %d", n.to_string().c_str(), 
           n.g_, n.cost_);
@@ -146,12 +206,34 @@ public:
   }
 
 public:
-  std::map<HashType, NodeType> map_;
+  Storage map_;
   SearchStats stats_;
 
 protected:
   HotQueue<NodeType, CostType, PositionMap,
       BinaryHeap<NodeType, CostType, PositionMap>> open_list_;
+  std::size_t open_count_ = 0;  // Entries in the open list.
+  std::size_t stale_count_ = 0; // Entries superseded by a lower cost.
+
+protected:
+  // An entry is stale if the node has been given a lower cost since it was
+  // inserted. Costs only decrease, so only the latest entry has the cost.
+  bool is_stale(const NodeType &n) const {
+    const NodeType &nn = map_.at(n.hash());
+    return nn.state_ != NodeState::open || nn.cost_ != n.cost_;
+  }
+
+  template<typename K, typename V, typename H>
+  static std::size_t count_collisions(const FlatHashMap<K, V, H> &storage,
+                                      const K &key) {
+    return storage.count_collisions(key);
+  }
+
+  // Other storages aren't searched by hash code.
+  template<typename S, typename K>
+  static std::size_t count_collisions(const S &, const K &) {
+    return 0;
+  }
 };
 
 }
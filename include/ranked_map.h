@@ -0,0 +1,82 @@
+#ifndef FUDGE_RANKED_MAP_H_
+#define FUDGE_RANKED_MAP_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// This stores values of a state space small enough to be indexed directly.
+// The ranker maps each key to a distinct index in [0, Ranker::kSize), like
+// PackedPermutationRank. An array of that size holds the index of the value of
+// each key in a contiguous arena, so a lookup is a rank and two array reads,
+// without hashing or comparing keys.
+//
+// It has the part of the interface of std::map used by PositionMap. Unlike
+// std::map, references to values are invalidated by insertions.
+
+namespace fudge {
+
+template <typename Key, typename Value, typename Ranker>
+class RankedMap {
+public:
+  RankedMap() : index_(Ranker::kSize, kNone) {};
+  virtual ~RankedMap() = default;
+
+public:
+  std::size_t size() const {
+    return values_.size();
+  }
+
+  std::size_t count(const Key &key) const {
+    return index_[ranker_(key)] != kNone ? 1 : 0;
+  }
+
+  Value &at(const Key &key) {
+    const uint32_t i = index_[ranker_(key)];
+    if (i == kNone)
+      throw std::out_of_range("RankedMap::at");
+    return values_[i];
+  }
+
+  const Value &at(const Key &key) const {
+    const uint32_t i = index_[ranker_(key)];
+    if (i == kNone)
+      throw std::out_of_range("RankedMap::at");
+    return values_[i];
+  }
+
+  // Return the value of the key, inserting a default one if there's none.
+  Value &operator[](const Key &key) {
+    uint32_t &i = index_[ranker_(key)];
+    if (i == kNone) {
+      i = values_.size();
+      values_.push_back(Value());
+    }
+    return values_[i];
+  }
+
+  void clear() {
+    values_.clear();
+    std::fill(index_.begin(), index_.end(), kNone);
+  }
+
+  std::size_t memory_usage() const {
+    return index_.size() * sizeof(uint32_t)
+        + values_.capacity() * sizeof(Value);
+  }
+
+private:
+  static constexpr uint32_t kNone = ~uint32_t(0);
+
+  std::vector<uint32_t> index_; // Index of the value by rank, or kNone.
+  std::vector<Value> values_;
+  Ranker ranker_;
+};
+
+template <typename Key, typename Value, typename Ranker>
+constexpr uint32_t RankedMap<Key, Value, Ranker>::kNone;
+
+}
+
+#endif /* FUDGE_RANKED_MAP_H_ */
@@ -1,52 +1,282 @@
 #ifndef FUDGE_RRA_H_
 #define FUDGE_RRA_H_
 
-#include <map>
+#include <algorithm>
+#include <list>
 #include <memory>
-#include "astar_search.h"
+#include <unordered_map>
 #include "grid_map.h"
+#include "versioned_matrix.h"
+#include "cache_stats.h"
+#include "search_stats.h"
 
 // This is an implementation of RRA* (Reverse Resumable A*) algorithm.
-// The instance keeps a series of maps with separated open list and different
-// start point. Each search will return the actual cost(g) from the start
-// position to end position. After the search, the map and open list is not
-// destroyed so that the next search could reuse the data.
+// The instance keeps a compact table of actual costs(g) and a saved open list
+// for each start point. Each search will return the actual cost(g) from the
+// start position to end position. If end is not closed yet, the search is
+// resumed from the saved open list instead of starting over. Tables are
+// evicted in LRU order once the byte budget is exceeded. When weights are
+// updated, only the tables which explored the updated cells are dropped.
 namespace fudge {
 
+// Actual costs from a start point to every node closed so far, together with
+// the open list of the reverse search so that it could be resumed later.
+// The heuristic target is fixed by the first query. Keeping it unchanged
+// keeps the priorities of the saved open list valid.
+template <typename CostType>
+class DistanceField {
+public:
+  DistanceField(int w, int h, const Coord &target)
+    : g_(w * h, static_cast<CostType>(-1)), closed_(w * h, false),
+      target_(target) {};
+
+public:
+  struct OpenEntry {
+    CostType f;
+    CostType g;
+    int index;
+  };
+
+  std::vector<CostType> g_;        // -1 if unexplored.
+  std::vector<bool> closed_;       // True if g_ is the actual cost.
+  std::vector<OpenEntry> open_;    // Binary heap ordered by f.
+  Coord target_;                   // Target used to calculate heuristic.
+
+public:
+  static bool less_priority(const OpenEntry &a, const OpenEntry &b) {
+    return a.f > b.f || (a.f == b.f && a.g < b.g);
+  }
+
+  bool is_closed(int i) const {
+    return closed_[i];
+  }
+
+  void push(int i, CostType g, CostType h) {
+    g_[i] = g;
+    open_.push_back(OpenEntry{g + h, g, i});
+    std::push_heap(open_.begin(), open_.end(), less_priority);
+  }
+
+  OpenEntry pop() {
+    std::pop_heap(open_.begin(), open_.end(), less_priority);
+    OpenEntry e = open_.back();
+    open_.pop_back();
+    return e;
+  }
+
+  // Return true if any node in the region or next to it is opened or closed.
+  // Costs of a table which has not reached the region are not affected by
+  // its weights. Neighbors are checked too, since a cell made passable was
+  // never explored itself, but may give shorter paths to those around it.
+  bool is_explored(const CellRegion &region, int w) const {
+    const int h = g_.size() / w;
+    const int x0 = std::max(region.x0_ - 1, 0);
+    const int y0 = std::max(region.y0_ - 1, 0);
+    const int x1 = std::min(region.x1_ + 1, w - 1);
+    const int y1 = std::min(region.y1_ + 1, h - 1);
+    for (int y = y0; y <= y1; y++) {
+      for (int x = x0; x <= x1; x++) {
+        if (g_[y * w + x] != -1)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  std::size_t bytes() const {
+    return sizeof(*this) + g_.capacity() * sizeof(CostType)
+        + closed_.capacity() / 8 + open_.capacity() * sizeof(OpenEntry);
+  }
+
+  // Expand nodes of the saved open list until the node at index i is closed
+  // or the open list runs out. Neighbors are the 4 adjacent passable nodes.
+  // The callback is invoked with the index of each node closed.
+  template <typename Heuristic, typename OnClosed>
+  void resume(const VertexMatrix<CostType> &vertex_matrix, int i,
+              Heuristic heuristic, SearchStats &stats, OnClosed on_closed) {
+    static constexpr int x_offsets[4] {0, -1, 1, 0};
+    static constexpr int y_offsets[4] {-1, 0, 0, 1};
+    const int w = vertex_matrix.width_;
+
+    while (!open_.empty() && !is_closed(i)) {
+      const OpenEntry top = pop();
+      if (is_closed(top.index) || top.g != g_[top.index])
+        continue; // Stale entry left by a cheaper path.
+
+      closed_[top.index] = true;
+      stats.nodes_closed++;
+      on_closed(top.index);
+
+      const Coord c(top.index % w, top.index / w);
+      for (int k = 0; k < 4; k++) {
+        const Coord n(c.first + x_offsets[k], c.second + y_offsets[k]);
+        if (!vertex_matrix.is_passable(n))
+          continue;
+
+        const int j = n.second * w + n.first;
+        CostType g = top.g + vertex_matrix.weight(n)
+            * GridMap<CostType>::kStraightEdgeWeight;
+        if (g_[j] == -1) {
+          push(j, g, heuristic(n, target_));
+          stats.nodes_opened++;
+        } else if (!is_closed(j) && g < g_[j]) {
+          push(j, g, heuristic(n, target_));
+          stats.nodes_priority_increased++;
+        }
+      }
+    }
+  }
+
+  void resume(const VertexMatrix<CostType> &vertex_matrix, int i,
+              CostType heuristic(const Coord&, const Coord&),
+              SearchStats &stats) {
+    resume(vertex_matrix, i, heuristic, stats, [](int) {});
+  }
+};
+
 template <typename CostType = double>
 class RRA {
 public:
-  RRA(const std::vector<CostType> &matrix, int w, int h)
-    : matrix_(matrix), w_(w), h_(h) {};
+  // A budget of 0 means the tables are never evicted.
+  RRA(const std::vector<CostType> &matrix, int w, int h,
+      std::size_t byte_budget = 0)
+    : vertex_matrix_(w, h, matrix), w_(w), h_(h),
+      byte_budget_(byte_budget) {};
+  RRA(const VertexMatrix<CostType> &vertex_matrix,
+      std::size_t byte_budget = 0)
+    : vertex_matrix_(vertex_matrix), w_(vertex_matrix.width_),
+      h_(vertex_matrix.height_), byte_budget_(byte_budget) {};
 
+  // Return the actual cost from start to end, or -1 if end is unreachable.
+  // The reverse search from start is resumed until end is closed. Each node is
+  // closed at most once per start point, so the cost is amortized O(1).
   CostType search(const Coord &start, const Coord &end,
                   CostType heuristic(const Coord&, const Coord&)){
-    DEBUG("RRA: Looking for map.");
-    if (maps_.find(start) == maps_.end()){
-      maps_[start] = std::move(
-          std::unique_ptr<GridMap<CostType>>(
-              new GridMap<CostType>(w_, h_, matrix_, false)));
-      DEBUG("RRA: New map created.");
+    if (!vertex_matrix_.is_passable(end))
+      return -1;
+
+    DEBUG("RRA: Looking for table.");
+    DistanceField<CostType> &field = touch(start, end, heuristic);
+    const int e = index(end);
+    if (field.is_closed(e)) {
+      stats_.hits++;
+      return field.g_[e];
     }
-    int g = maps_.at(start)->node(end)->g_;
-    if (g != -1)
-      return g;
-    else {
-      DEBUG("RRA: Start search.");
-      std::vector<Coord> &&path = astar_search(
-          *(maps_.at(start)), 
-          start, end,
-          heuristic);
-      DEBUG("RRA: End search.");
-      return maps_.at(start)->node(path.front())->g_;
+
+    stats_.misses++;
+    DEBUG("RRA: Resume search.");
+    field.resume(vertex_matrix_, e, heuristic, search_stats_);
+    DEBUG("RRA: End search.");
+    account(start);
+    evict();
+    return field.is_closed(e) ? field.g_[e] : static_cast<CostType>(-1);
+  }
+
+  // Drop the tables which explored any node in or next to the region. Call
+  // this after the weights in the region are updated in place.
+  void invalidate(const CellRegion &region) {
+    if (region.empty())
+      return;
+    for (auto i = fields_.begin(); i != fields_.end();) {
+      if (i->second.field->is_explored(region, w_)) {
+        stats_.bytes -= i->second.bytes;
+        lru_.erase(i->second.lru);
+        i = fields_.erase(i);
+        stats_.invalidations++;
+      } else {
+        ++i;
+      }
     }
+    stats_.entries = fields_.size();
   }
 
+  // Move to the latest snapshot of the matrix, dropping the tables affected
+  // by the updates since the current one.
+  void sync(const VersionedMatrix<CostType> &matrix) {
+    if (matrix.version() == vertex_matrix_.version_)
+      return;
+    invalidate(matrix.dirty_since(vertex_matrix_.version_));
+    vertex_matrix_ = matrix.snapshot();
+  }
+
+  void clear() {
+    fields_.clear();
+    lru_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+  }
+
+public:
+  CacheStats stats_;
+  SearchStats search_stats_;
+
 private:
-  const std::vector<CostType> &matrix_;
-  std::map<Coord, std::unique_ptr<GridMap<CostType>>> maps_;
+  struct Entry {
+    std::unique_ptr<DistanceField<CostType>> field;
+    std::list<CellId>::iterator lru;
+    std::size_t bytes;
+  };
+
+  VertexMatrix<CostType> vertex_matrix_;
+  std::unordered_map<CellId, Entry> fields_; // Keyed by start point.
+  std::list<CellId> lru_; // Most recently used first.
   int w_;
   int h_;
+  std::size_t byte_budget_;
+
+private:
+  int index(const Coord &c) const {
+    return c.second * w_ + c.first;
+  }
+
+  // Return the table of the start point and mark it as most recently used.
+  // A new table starts its search towards the target.
+  DistanceField<CostType> &touch(const Coord &start, const Coord &target,
+      CostType heuristic(const Coord&, const Coord&)) {
+    auto i = fields_.find(cell_id(start));
+    if (i != fields_.end()) {
+      lru_.splice(lru_.begin(), lru_, i->second.lru);
+      return *(i->second.field);
+    }
+
+    std::unique_ptr<DistanceField<CostType>> field(
+        new DistanceField<CostType>(w_, h_, target));
+    field->push(index(start), 0, heuristic(start, target));
+    search_stats_.nodes_opened++;
+    lru_.push_front(cell_id(start));
+    Entry &e = fields_[cell_id(start)];
+    e.field = std::move(field);
+    e.lru = lru_.begin();
+    e.bytes = 0;
+    account(start);
+    evict();
+    DEBUG("RRA: New table created.");
+    return *(e.field);
+  }
+
+  // Refresh the bytes used by the table of the start point.
+  void account(const Coord &start) {
+    Entry &e = fields_.at(cell_id(start));
+    std::size_t bytes = e.field->bytes();
+    stats_.bytes = stats_.bytes - e.bytes + bytes;
+    e.bytes = bytes;
+  }
+
+  // Evict least recently used tables until the budget is met. The most
+  // recently used table is always kept.
+  void evict() {
+    if (byte_budget_ != 0) {
+      while (lru_.size() > 1 && stats_.bytes > byte_budget_) {
+        auto i = fields_.find(lru_.back());
+        stats_.bytes -= i->second.bytes;
+        fields_.erase(i);
+        lru_.pop_back();
+        stats_.evictions++;
+        DEBUG("RRA: Table evicted.");
+      }
+    }
+    stats_.entries = fields_.size();
+  }
 };
 
 }
@@ -12,6 +12,7 @@ public:
   int nodes_closed = 0;
   int nodes_reopened = 0;
   int nodes_priority_increased = 0;
+  int hash_collisions = 0; // Distinct nodes found of the same hash code.
 
 public:
   void reset() {
@@ -19,6 +20,7 @@ public:
     nodes_closed = 0;
     nodes_reopened = 0;
     nodes_priority_increased = 0;
+    hash_collisions = 0;
   }
 
   const std::string to_string() const {
@@ -27,6 +29,9 @@ public:
        << "  nodes closed:" << nodes_closed << '\n'
        << "  nodes priority increased:" << nodes_priority_increased << '\n'
        << "  nodes reopened:" << nodes_reopened << '\n';
+    // Only maps comparing nodes of the same hash count collisions.
+    if (hash_collisions > 0)
+      ss << "  hash collisions:" << hash_collisions << '\n';
     return ss.str();
   }
 };
@@ -0,0 +1,140 @@
+#ifndef FUDGE_SHARED_RRA_H_
+#define FUDGE_SHARED_RRA_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "rra.h"
+
+// This is a thread safe version of RRA* to be shared by several maps and
+// threads. Each start point owns a reverse search guarded by its own mutex.
+// Actual costs are published to an array of atomics once their nodes are
+// closed, so that finished costs are read without any lock. Only a query for
+// a node which is not closed yet takes the lock and extends the search.
+// Tables are never evicted because a reader might still be using them.
+namespace fudge {
+
+template <typename CostType = double>
+class SharedRRA {
+public:
+  SharedRRA(const std::vector<CostType> &matrix, int w, int h)
+    : vertex_matrix_(w, h, matrix), w_(w), h_(h),
+      slots_(new std::atomic<Slot*>[w * h]) {
+    for (int i = 0; i < w * h; i++)
+      slots_[i].store(nullptr, std::memory_order_relaxed);
+  };
+  explicit SharedRRA(const VertexMatrix<CostType> &vertex_matrix)
+    : vertex_matrix_(vertex_matrix), w_(vertex_matrix.width_),
+      h_(vertex_matrix.height_), slots_(new std::atomic<Slot*>[w_ * h_]) {
+    for (int i = 0; i < w_ * h_; i++)
+      slots_[i].store(nullptr, std::memory_order_relaxed);
+  };
+
+  SharedRRA(const SharedRRA &) = delete;
+  SharedRRA &operator =(const SharedRRA &) = delete;
+
+public:
+  // Return the actual cost from start to end, or -1 if end is unreachable.
+  CostType search(const Coord &start, const Coord &end,
+                  CostType heuristic(const Coord&, const Coord&)) {
+    if (!vertex_matrix_.is_passable(end))
+      return -1;
+
+    const int e = index(end);
+    Slot *slot = slots_[index(start)].load(std::memory_order_acquire);
+    if (slot == nullptr)
+      slot = create(start, end, heuristic);
+
+    // Lock free path for costs already published.
+    CostType g = slot->costs_[e].load(std::memory_order_acquire);
+    if (g != -1 || slot->exhausted_.load(std::memory_order_acquire)) {
+      hits_++;
+      return g;
+    }
+
+    std::lock_guard<std::mutex> lock(slot->mutex_);
+    misses_++;
+    slot->field_.resume(vertex_matrix_, e, heuristic, slot->stats_,
+        [slot](int i) {
+          slot->costs_[i].store(slot->field_.g_[i], std::memory_order_release);
+        });
+    if (slot->field_.open_.empty())
+      slot->exhausted_.store(true, std::memory_order_release);
+    return slot->costs_[e].load(std::memory_order_relaxed);
+  }
+
+  // Return a snapshot of the statistics.
+  CacheStats stats() const {
+    CacheStats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.entries = owned_.size();
+    for (auto &slot : owned_)
+      stats.bytes += slot->bytes();
+    return stats;
+  }
+
+private:
+  // Search state of a start point.
+  class Slot {
+  public:
+    Slot(int w, int h, const Coord &target)
+      : field_(w, h, target), costs_(new std::atomic<CostType>[w * h]),
+        size_(w * h) {
+      for (int i = 0; i < size_; i++)
+        costs_[i].store(static_cast<CostType>(-1), std::memory_order_relaxed);
+    }
+
+  public:
+    std::mutex mutex_;                           // Guards field_ and stats_.
+    DistanceField<CostType> field_;
+    SearchStats stats_;
+    std::unique_ptr<std::atomic<CostType>[]> costs_; // Published costs.
+    std::atomic<bool> exhausted_ {false};        // All nodes reached closed.
+    int size_;
+
+  public:
+    std::size_t bytes() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return sizeof(*this) + field_.bytes()
+          + size_ * sizeof(std::atomic<CostType>);
+    }
+  };
+
+  const VertexMatrix<CostType> vertex_matrix_;
+  int w_;
+  int h_;
+  std::unique_ptr<std::atomic<Slot*>[]> slots_; // Indexed by start point.
+  std::vector<std::unique_ptr<Slot>> owned_;
+  mutable std::mutex mutex_;                     // Guards owned_.
+  std::atomic<int> hits_ {0};
+  std::atomic<int> misses_ {0};
+
+private:
+  int index(const Coord &c) const {
+    return c.second * w_ + c.first;
+  }
+
+  // Create the slot of the start point unless another thread has done it.
+  Slot *create(const Coord &start, const Coord &target,
+               CostType heuristic(const Coord&, const Coord&)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = slots_[index(start)].load(std::memory_order_acquire);
+    if (slot != nullptr)
+      return slot;
+
+    owned_.emplace_back(new Slot(w_, h_, target));
+    slot = owned_.back().get();
+    slot->field_.push(index(start), 0, heuristic(start, target));
+    slot->stats_.nodes_opened++;
+    slots_[index(start)].store(slot, std::memory_order_release);
+    DEBUG("SharedRRA: New table created.");
+    return slot;
+  }
+};
+
+}
+
+#endif /* FUDGE_SHARED_RRA_H_ */
@@ -0,0 +1,85 @@
+#ifndef FUDGE_SPARSE_GRID_NODE_ARRAY_H_
+#define FUDGE_SPARSE_GRID_NODE_ARRAY_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "grid_node.h"
+
+// This holds grid nodes in square chunks allocated when a node in them is
+// touched for the first time. Memory is proportional to the area explored
+// rather than to the size of the map. Nodes never move once allocated. They
+// keep wide cell ids by default, so the map could be of any size.
+
+namespace fudge {
+
+template<typename CostType, typename Id = WideCellId>
+class SparseGridNodeArray {
+public:
+  using Node = GridNode<CostType, Id>;
+
+public:
+  // The chunk size should be a power of 2.
+  explicit SparseGridNodeArray(int chunk_size = 64) : shift_(0) {
+    while ((1 << shift_) < chunk_size)
+      shift_++;
+  }
+
+  virtual ~SparseGridNodeArray() = default;
+
+public:
+  void reset() {
+    chunks_.clear();
+    last_key_ = -1;
+    last_chunk_ = nullptr;
+  }
+
+  Node *node(Coord coord) const {
+    const int64_t key = (static_cast<int64_t>(coord.second >> shift_) << 32)
+        | static_cast<uint32_t>(coord.first >> shift_);
+    if (key != last_key_) {
+      std::unique_ptr<Node[]> &chunk = chunks_[key];
+      if (!chunk)
+        chunk = allocate(coord);
+      last_key_ = key;
+      last_chunk_ = chunk.get();
+    }
+    const int mask = (1 << shift_) - 1;
+    return &last_chunk_[((coord.second & mask) << shift_)
+        + (coord.first & mask)];
+  }
+
+  std::size_t chunks() const {
+    return chunks_.size();
+  }
+
+  std::size_t bytes() const {
+    return chunks_.size() * (sizeof(Node) << (shift_ * 2));
+  }
+
+private:
+  int shift_;
+  mutable std::unordered_map<int64_t,
+      std::unique_ptr<Node[]>> chunks_;
+  mutable int64_t last_key_ = -1;
+  mutable Node *last_chunk_ = nullptr;
+
+private:
+  std::unique_ptr<Node[]> allocate(const Coord &coord) const {
+    const int size = 1 << shift_;
+    const int x0 = coord.first & ~(size - 1);
+    const int y0 = coord.second & ~(size - 1);
+    std::unique_ptr<Node[]> chunk(
+        new Node[size * size]);
+    for (int i = 0; i < size; i++) {
+      for (int j = 0; j < size; j++) {
+        chunk[i * size + j].c(Coord(x0 + j, y0 + i));
+      }
+    }
+    return chunk;
+  }
+};
+
+}
+
+#endif /* FUDGE_SPARSE_GRID_NODE_ARRAY_H_ */
@@ -0,0 +1,60 @@
+#ifndef FUDGE_STATIC_GRID_MAP_H_
+#define FUDGE_STATIC_GRID_MAP_H_
+
+#include <vector>
+#include "grid_map.h"
+
+// This is a GridMap whose width, height and connectivity are known at compile
+// time, for maps of a fixed size. Nodes are indexed with a constant width, and
+// edges are generated from a constant table of neighbors, so there's no check
+// of the connectivity at runtime.
+
+namespace fudge {
+
+template <typename CostType, int kWidth, int kHeight, bool kDiagonal = true>
+class StaticGridMap
+    : public GridMap<CostType, FixedRowMajorLayout<kWidth, kHeight>> {
+public:
+  using Layout = FixedRowMajorLayout<kWidth, kHeight>;
+  using Base = GridMap<CostType, Layout>;
+
+public:
+  explicit StaticGridMap(const std::vector<CostType> &matrix)
+    : Base(kWidth, kHeight, matrix, kDiagonal) {};
+  explicit StaticGridMap(const VertexMatrix<CostType, Layout> &vertex_matrix)
+    : Base(vertex_matrix, kDiagonal) {};
+  virtual ~StaticGridMap() = default;
+
+public:
+  static constexpr int kNeighbors = kDiagonal ? 8 : 4;
+
+public:
+  virtual const std::vector<Edge<Coord, CostType>>
+  edges(const Coord &n) override {
+    // Same order as GridMap, so ties are broken the same way.
+    static constexpr int x_offsets[2][8] {
+        {0, -1, 1, 0},
+        {-1, 0, 1, -1, 1, -1, 0, 1}};
+    static constexpr int y_offsets[2][8] {
+        {-1, 0, 0, 1},
+        {-1, -1, -1, 0, 0, 1, 1, 1}};
+
+    std::vector<Edge<Coord, CostType>> es;
+    es.reserve(kNeighbors);
+    for (int i = 0; i < kNeighbors; i++) {
+      const int dx = x_offsets[kDiagonal][i];
+      const int dy = y_offsets[kDiagonal][i];
+      const Coord c(n.first + dx, n.second + dy);
+      if (this->is_passable(c)) {
+        es.push_back(Edge<Coord, CostType>(n, c,
+            this->vertex_matrix_.weight(c) * (dx == 0 || dy == 0
+                ? Base::kStraightEdgeWeight : Base::kDiagonalEdgeWeight)));
+      }
+    }
+    return es;
+  }
+};
+
+}
+
+#endif /* FUDGE_STATIC_GRID_MAP_H_ */
@@ -0,0 +1,72 @@
+#ifndef FUDGE_MAPPED_FILE_H_
+#define FUDGE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fudge {
+
+// A read only memory mapped file. The pages are shared with other processes
+// mapping the same file through the page cache.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0) {
+      size_ = st.st_size;
+      if (size_ > 0) {
+        void *p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+          data_ = static_cast<const char *>(p);
+      }
+      opened_ = size_ == 0 || data_ != nullptr;
+    }
+    ::close(fd);
+  }
+
+  MappedFile(MappedFile &&f) : data_(f.data_), size_(f.size_),
+      opened_(f.opened_) {
+    f.data_ = nullptr;
+    f.size_ = 0;
+    f.opened_ = false;
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator =(const MappedFile &) = delete;
+
+  virtual ~MappedFile() {
+    if (data_ != nullptr)
+      ::munmap(const_cast<char *>(data_), size_);
+  }
+
+public:
+  // Return true if the file is opened, even if it's empty.
+  bool is_open() const {
+    return opened_;
+  }
+
+  const char *data() const {
+    return data_;
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool opened_ = false;
+};
+
+}
+
+#endif /* FUDGE_MAPPED_FILE_H_ */
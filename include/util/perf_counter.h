@@ -0,0 +1,93 @@
+#ifndef FUDGE_PERF_COUNTER_H_
+#define FUDGE_PERF_COUNTER_H_
+
+#include <cstdint>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Count a hardware event of the calling thread, like cache misses, with
+// perf_event_open(2). Counters are often not allowed in containers or by
+// perf_event_paranoid, and don't exist on other systems. Check is_open()
+// before trusting the value.
+
+namespace fudge {
+
+class PerfCounter {
+public:
+#ifdef __linux__
+  static constexpr uint32_t kHardware = PERF_TYPE_HARDWARE;
+  static constexpr uint32_t kHardwareCache = PERF_TYPE_HW_CACHE;
+  static constexpr uint64_t kCacheMisses = PERF_COUNT_HW_CACHE_MISSES;
+  static constexpr uint64_t kL1DataReadMisses = PERF_COUNT_HW_CACHE_L1D
+      | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+  PerfCounter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  virtual ~PerfCounter() {
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  bool is_open() const {
+    return fd_ >= 0;
+  }
+
+  void start() {
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  void stop() {
+    if (fd_ >= 0)
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+  }
+
+  // Return the count since start(), or 0 if the counter is not open.
+  uint64_t value() const {
+    uint64_t v = 0;
+    if (fd_ < 0 || ::read(fd_, &v, sizeof(v)) != sizeof(v))
+      return 0;
+    return v;
+  }
+
+private:
+  int fd_ = -1;
+#else
+  static constexpr uint32_t kHardware = 0;
+  static constexpr uint32_t kHardwareCache = 0;
+  static constexpr uint64_t kCacheMisses = 0;
+  static constexpr uint64_t kL1DataReadMisses = 0;
+
+  PerfCounter(uint32_t, uint64_t) {}
+  virtual ~PerfCounter() {}
+  bool is_open() const { return false; }
+  void start() {}
+  void stop() {}
+  uint64_t value() const { return 0; }
+#endif
+
+  PerfCounter(const PerfCounter &) = delete;
+  PerfCounter &operator =(const PerfCounter &) = delete;
+};
+
+}
+
+#endif /* FUDGE_PERF_COUNTER_H_ */
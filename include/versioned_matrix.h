@@ -0,0 +1,172 @@
+#ifndef FUDGE_VERSIONED_MATRIX_H_
+#define FUDGE_VERSIONED_MATRIX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "util/log.h"
+#include "vertex_matrix.h"
+
+// This implements a weight matrix which owns its weights and could be updated
+// safely while searches are running on it. Searches run on snapshots, which
+// share the weights with the matrix. An update copies the weights first if a
+// snapshot is still using them, so a snapshot never changes. Each batch of
+// updates bumps the version and records the bounding box of updated cells,
+// so that caches built on a snapshot could drop only what is affected. A
+// passability bitmap is updated along with the weights and shared the same way.
+//
+// Snapshots could be used by any thread. Updates and snapshot() should be
+// called by one thread at a time.
+
+namespace fudge {
+
+// A rectangle of cells from (x0, y0) to (x1, y1) inclusive.
+class CellRegion {
+public:
+  CellRegion() = default;
+  CellRegion(int x0, int y0, int x1, int y1)
+    : x0_(x0), y0_(y0), x1_(x1), y1_(y1) {};
+
+public:
+  int x0_ = 0;
+  int y0_ = 0;
+  int x1_ = -1;
+  int y1_ = -1;
+
+public:
+  bool empty() const {
+    return x1_ < x0_ || y1_ < y0_;
+  }
+
+  bool contains(const Coord &c) const {
+    return c.first >= x0_ && c.first <= x1_ &&
+        c.second >= y0_ && c.second <= y1_;
+  }
+
+  void merge(const Coord &c) {
+    merge(CellRegion(c.first, c.second, c.first, c.second));
+  }
+
+  void merge(const CellRegion &r) {
+    if (r.empty())
+      return;
+    if (empty()) {
+      *this = r;
+      return;
+    }
+    x0_ = std::min(x0_, r.x0_);
+    y0_ = std::min(y0_, r.y0_);
+    x1_ = std::max(x1_, r.x1_);
+    y1_ = std::max(y1_, r.y1_);
+  }
+};
+
+template <typename WeightType>
+class CellUpdate {
+public:
+  Coord coord_;
+  WeightType weight_;
+};
+
+template <typename WeightType>
+class VersionedMatrix {
+public:
+  VersionedMatrix(int w, int h, std::vector<WeightType> matrix)
+    : width_(w), height_(h),
+      matrix_(std::make_shared<std::vector<WeightType>>(std::move(matrix))),
+      passability_(std::make_shared<PassabilityBitmap>(w, h)) {
+    for (int y = 0; y < height_; y++) {
+      for (int x = 0; x < width_; x++)
+        passability_->set(Coord(x, y), weight(Coord(x, y)) >= 0);
+    }
+  }
+  virtual ~VersionedMatrix() = default;
+
+public:
+  // Count of dirty regions remembered. Older updates are reported as the
+  // whole matrix.
+  static constexpr std::size_t kHistorySize = 64;
+
+  const int width_;
+  const int height_;
+
+public:
+  uint64_t version() const {
+    return version_;
+  }
+
+  WeightType weight(const Coord &c) const {
+    return (*matrix_)[c.second * width_ + c.first];
+  }
+
+  // Return an immutable view of the current weights, which stays valid even
+  // after the matrix is updated or destroyed.
+  VertexMatrix<WeightType> snapshot() const {
+    return VertexMatrix<WeightType>(width_, height_,
+        std::shared_ptr<const std::vector<WeightType>>(matrix_), version_,
+        std::shared_ptr<const PassabilityBitmap>(passability_));
+  }
+
+  // Set the weights of cells and bump the version. If any cell is off the
+  // matrix, an error is logged and nothing is updated.
+  bool apply_updates(const std::vector<CellUpdate<WeightType>> &updates) {
+    CellRegion region;
+    for (const CellUpdate<WeightType> &u : updates) {
+      if (u.coord_.first < 0 || u.coord_.first >= width_ ||
+          u.coord_.second < 0 || u.coord_.second >= height_) {
+        ERROR("Update of (%d,%d) is off the matrix.", u.coord_.first,
+              u.coord_.second);
+        return false;
+      }
+      region.merge(u.coord_);
+    }
+    if (region.empty())
+      return true;
+
+    // Copy on write if a snapshot shares the weights.
+    if (matrix_.use_count() > 1)
+      matrix_ = std::make_shared<std::vector<WeightType>>(*matrix_);
+    if (passability_.use_count() > 1)
+      passability_ = std::make_shared<PassabilityBitmap>(*passability_);
+    for (const CellUpdate<WeightType> &u : updates) {
+      (*matrix_)[u.coord_.second * width_ + u.coord_.first] = u.weight_;
+      passability_->set(u.coord_, u.weight_ >= 0);
+    }
+
+    version_++;
+    history_.push_back(std::make_pair(version_, region));
+    if (history_.size() > kHistorySize)
+      history_.pop_front();
+    return true;
+  }
+
+  // Return the bounding box of cells updated after the version.
+  CellRegion dirty_since(uint64_t version) const {
+    CellRegion region;
+    if (version >= version_)
+      return region;
+    if (history_.empty() || history_.front().first > version + 1)
+      return CellRegion(0, 0, width_ - 1, height_ - 1);
+    for (const auto &h : history_) {
+      if (h.first > version)
+        region.merge(h.second);
+    }
+    return region;
+  }
+
+private:
+  std::shared_ptr<std::vector<WeightType>> matrix_;
+  std::shared_ptr<PassabilityBitmap> passability_;
+  uint64_t version_ = 0;
+  std::deque<std::pair<uint64_t, CellRegion>> history_;
+};
+
+template <typename WeightType>
+constexpr std::size_t VersionedMatrix<WeightType>::kHistorySize;
+
+}
+
+#endif /* FUDGE_VERSIONED_MATRIX_H_ */
@@ -2,28 +2,57 @@
 #define FUDGE_VERTEX_MATRIX_H_
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include <string>
 #include <sstream>
 #include <limits>
+#include <type_traits>
+#include "grid_layout.h"
+#include "passability_bitmap.h"
 
 namespace fudge {
 
-using Coord = std::pair<int,int>;
-
-template<typename WeightType>
+// The matrix does not own the weights by default. It could be a view of a
+// vector, or of weights stored elsewhere like a memory mapped file. A matrix
+// made from a shared vector keeps the weights alive, like a snapshot taken
+// from VersionedMatrix.
+//
+// Weights are always given in row-major order. With any other layout, the
+// matrix keeps its own copy of the weights arranged in that layout.
+//
+// A matrix could carry a passability bitmap kept in sync with the weights,
+// like a snapshot taken from VersionedMatrix. Maps read the weights otherwise.
+template<typename WeightType, typename Layout = RowMajorLayout>
 class VertexMatrix {
 public:
   VertexMatrix(int width, int height, const std::vector<WeightType> &matrix):
-       width_(width), height_(height), matrix_(matrix) {}
+       width_(width), height_(height), layout_(width, height) {
+    arrange(matrix.data(), nullptr);
+  }
+  VertexMatrix(int width, int height, const WeightType *matrix):
+       width_(width), height_(height), layout_(width, height) {
+    arrange(matrix, nullptr);
+  }
+  VertexMatrix(int width, int height,
+               std::shared_ptr<const std::vector<WeightType>> matrix,
+               uint64_t version = 0,
+               std::shared_ptr<const PassabilityBitmap> passability = nullptr):
+       width_(width), height_(height), version_(version),
+       layout_(width, height), passability_(passability) {
+    arrange(matrix->data(), matrix);
+  }
   virtual ~VertexMatrix() {}
 
 public:
   int width_ = 0;
   int height_ = 0;
+  uint64_t version_ = 0;  // Version of the weights if taken from a snapshot.
 
 public:
   const WeightType weight(Coord coord) const {
-    return matrix_[coord.second * width_ + coord.first];
+    return matrix_[layout_.index(coord)];
   }
 
   bool is_off(Coord coord) const {
@@ -60,8 +89,43 @@ public:
     return ss.str();
   }
 
+  // Return the weights in the order of the layout.
+  const WeightType *data() const {
+    return matrix_;
+  }
+
+  // Return the bitmap of cells with weights not below 0, or nullptr if the
+  // matrix does not carry one.
+  std::shared_ptr<const PassabilityBitmap> passability() const {
+    return passability_;
+  }
+
+private:
+  Layout layout_;
+  const WeightType *matrix_ = nullptr;
+  std::shared_ptr<const std::vector<WeightType>> owner_;
+  std::shared_ptr<const PassabilityBitmap> passability_;
+
 private:
-  const std::vector<WeightType> &matrix_;
+  // Keep a view of row-major weights, or a copy arranged in the layout.
+  void arrange(const WeightType *row_major,
+               std::shared_ptr<const std::vector<WeightType>> owner) {
+    if (IsRowMajor<Layout>::value) {
+      matrix_ = row_major;
+      owner_ = owner;
+      return;
+    }
+
+    std::shared_ptr<std::vector<WeightType>> v =
+        std::make_shared<std::vector<WeightType>>(layout_.size(),
+                                                  static_cast<WeightType>(-1));
+    for (int y = 0; y < height_; y++) {
+      for (int x = 0; x < width_; x++)
+        (*v)[layout_.index(Coord(x, y))] = row_major[y * width_ + x];
+    }
+    matrix_ = v->data();
+    owner_ = v;
+  }
 };
 
 }
@@ -0,0 +1,188 @@
+#ifndef FUDGE_XOR_SEARCH_H_
+#define FUDGE_XOR_SEARCH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "util/log.h"
+
+// A breadth first search for puzzles whose state is a word of bits, and whose
+// every move XORs the state with a mask of its own, like turning torches on
+// and off. Visited states are kept in a dense array of 2 bits per state, so
+// there's no hashing at all.
+//
+// Moves commute, so the states k moves away from a state s are s XOR the
+// states k moves away from 0. Only states around 0 are searched then: a
+// state x of depth a, with x XOR start XOR goal of depth b, gives a path of
+// a + b moves. Those of the first layer meeting any are the shortest, found
+// at half the depth of the path.
+//
+// The 2 bits of a state tell if it's visited and its depth modulo 3. Moves
+// are their own inverse, so neighbors of a state of depth d are of depth
+// d - 1, d or d + 1, and the moves back to 0 are found by the depth modulo 3
+// alone. Only the layer expanded and the next one are kept besides.
+//
+// A goal is reachable only if start XOR goal is an XOR of masks, which is
+// checked first by Gaussian elimination over GF(2), so a goal out of reach
+// takes no search at all.
+//
+// An array of 2^(n+1) bits is taken, so n is limited to kMaxBits.
+
+namespace fudge {
+
+class XorSearch {
+public:
+  XorSearch(const std::vector<uint64_t> &masks, int bits)
+    : masks_(masks), bits_(bits) {};
+  virtual ~XorSearch() = default;
+
+public:
+  static constexpr int kMaxBits = 32;
+
+public:
+  // Return true if the goal is reachable, after which moves() gives the
+  // least moves to reach it.
+  bool search(uint64_t start, uint64_t goal) {
+    moves_.clear();
+    start_ = start;
+    nodes_visited_ = 0;
+    if (bits_ > kMaxBits) {
+      ERROR("Too many bits for a dense search: %d", bits_);
+      return false;
+    }
+
+    const uint64_t target = start ^ goal;
+    if (!is_spanned(target))
+      return false; // No moves XOR to the target.
+
+    depths_.assign(((uint64_t(1) << bits_) + 31) / 32, 0);
+    layer_.clear();
+    next_.clear();
+    visit(0, 0);
+    layer_.swap(next_);
+    if (target == 0)
+      return true;
+
+    for (int depth = 0; !layer_.empty(); depth++) {
+      int best = -1;
+      uint64_t meet = 0;
+      for (uint64_t x : layer_) {
+        const int d = meet_depth(x ^ target, depth);
+        if (d >= 0 && (best < 0 || d < best)) {
+          best = d;
+          meet = x;
+        }
+      }
+      if (best >= 0) {
+        trace(meet, moves_);
+        std::reverse(moves_.begin(), moves_.end());
+        trace(meet ^ target, moves_);
+        return true;
+      }
+      expand(depth);
+    }
+    return false; // Every state reachable has been visited.
+  }
+
+  // Indices of masks of the moves, from the start to the goal.
+  const std::vector<int> &moves() const {
+    return moves_;
+  }
+
+  // Return the states from the goal back to the start, as astar_search.
+  std::vector<uint64_t> path() const {
+    std::vector<uint64_t> states {start_};
+    for (int m : moves_)
+      states.push_back(states.back() ^ masks_[m]);
+    return std::vector<uint64_t>(states.rbegin(), states.rend());
+  }
+
+  std::size_t nodes_visited() const {
+    return nodes_visited_;
+  }
+
+  std::size_t memory_usage() const {
+    return (depths_.capacity() + layer_.capacity() + next_.capacity())
+        * sizeof(uint64_t);
+  }
+
+private:
+  std::vector<uint64_t> masks_;
+  int bits_ = 0;
+  uint64_t start_ = 0;
+  std::vector<uint64_t> depths_; // 2 bits per state, 0 if not visited.
+  std::vector<uint64_t> layer_;
+  std::vector<uint64_t> next_;
+  std::vector<int> moves_;
+  std::size_t nodes_visited_ = 0;
+
+private:
+  // Return 0 if the state is not visited, or its depth modulo 3 plus 1.
+  int mark(uint64_t s) const {
+    return (depths_[s >> 5] >> ((s & 31) * 2)) & 3;
+  }
+
+  void visit(uint64_t s, int depth) {
+    depths_[s >> 5] |= uint64_t(depth % 3 + 1) << ((s & 31) * 2);
+    next_.push_back(s);
+    nodes_visited_++;
+  }
+
+  // Return the depth of a state met by one of the layer of the depth, or -1
+  // if it's not visited. No layer before met any, so it's of the depth or the
+  // one before.
+  int meet_depth(uint64_t s, int depth) const {
+    const int m = mark(s);
+    if (m == 0)
+      return -1;
+    return (m - 1) == depth % 3 ? depth : depth - 1;
+  }
+
+  void expand(int depth) {
+    next_.clear();
+    for (uint64_t s : layer_) {
+      for (uint64_t m : masks_) {
+        if (mark(s ^ m) == 0)
+          visit(s ^ m, depth + 1);
+      }
+    }
+    layer_.swap(next_);
+  }
+
+  // Append the moves from a state back to 0, through neighbors of the depth
+  // before, which are the only ones of their depth modulo 3.
+  void trace(uint64_t s, std::vector<int> &moves) const {
+    while (s != 0) {
+      const int before = (mark(s) + 1) % 3 + 1;
+      for (std::size_t m = 0; m < masks_.size(); m++) {
+        if (mark(s ^ masks_[m]) == before) {
+          moves.push_back(m);
+          s ^= masks_[m];
+          break;
+        }
+      }
+    }
+  }
+
+  // Return true if the state is an XOR of masks. Masks are reduced to a
+  // basis of distinct highest bits, kept in descending order, so XOR with a
+  // basis mask clears its highest bit whenever that makes a state smaller.
+  bool is_spanned(uint64_t s) const {
+    std::vector<uint64_t> basis;
+    for (uint64_t m : masks_) {
+      for (uint64_t b : basis)
+        m = std::min(m, m ^ b);
+      if (m != 0) {
+        basis.push_back(m);
+        std::sort(basis.rbegin(), basis.rend());
+      }
+    }
+    for (uint64_t b : basis)
+      s = std::min(s, s ^ b);
+    return s == 0;
+  }
+};
+
+}
+
+#endif /* FUDGE_XOR_SEARCH_H_ */
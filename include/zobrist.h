@@ -0,0 +1,104 @@
+#ifndef FUDGE_ZOBRIST_H_
+#define FUDGE_ZOBRIST_H_
+
+#include <cstdint>
+#include <functional>
+
+// Zobrist hashing of states made of components, like the jugs of a water jug
+// puzzle or the agents of a multi agent map. The hash of a state is the XOR
+// of a random looking key for each component and its value. A successor
+// changing a few components takes the hash of its parent and XORs out the
+// old keys and in the new ones, in O(1) per component changed, instead of
+// hashing the whole state again.
+//
+// Keys are made by mixing the component and the value, rather than taken from
+// a table, so neither has to be bounded. Distinct states may share a hash, so
+// states should still be compared when hashes are equal, as ZobristKey does.
+
+namespace fudge {
+
+// Key of a component with a value, by the finalizer of splitmix64.
+inline uint64_t zobrist_key(uint64_t component, uint64_t value) {
+  uint64_t x = (component << 40) ^ value ^ 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+class ZobristHash {
+public:
+  ZobristHash() = default;
+  explicit ZobristHash(uint64_t value) : value_(value) {};
+
+public:
+  uint64_t value() const {
+    return value_;
+  }
+
+  // Add or remove a component. Doing it twice takes it back.
+  void toggle(uint64_t component, uint64_t value) {
+    value_ ^= zobrist_key(component, value);
+  }
+
+  // Change the value of a component.
+  void update(uint64_t component, uint64_t from, uint64_t to) {
+    value_ ^= zobrist_key(component, from) ^ zobrist_key(component, to);
+  }
+
+  bool operator ==(const ZobristHash &h) const {
+    return value_ == h.value_;
+  }
+
+  bool operator !=(const ZobristHash &h) const {
+    return value_ != h.value_;
+  }
+
+private:
+  uint64_t value_ = 0;
+};
+
+// A state with its Zobrist hash, as the key of explored states. A node could
+// keep its state in a key, updating both as it moves, so that the key is
+// taken without a copy. Keys are hashed by the Zobrist hash, without going
+// through the state again, but compared by state too, so distinct states of
+// the same hash are kept apart.
+template <typename State>
+class ZobristKey {
+public:
+  ZobristKey() = default;
+  ZobristKey(const ZobristHash &zobrist, const State &state)
+    : zobrist_(zobrist), state_(state) {};
+
+public:
+  ZobristHash zobrist_;
+  State state_;
+
+public:
+  bool operator ==(const ZobristKey &k) const {
+    return zobrist_ == k.zobrist_ && state_ == k.state_;
+  }
+
+  bool operator !=(const ZobristKey &k) const {
+    return !(*this == k);
+  }
+
+  bool operator <(const ZobristKey &k) const {
+    return zobrist_.value() < k.zobrist_.value()
+        || (zobrist_ == k.zobrist_ && state_ < k.state_);
+  }
+};
+
+}
+
+namespace std {
+
+template <typename State>
+struct hash<fudge::ZobristKey<State>> {
+  std::size_t operator()(const fudge::ZobristKey<State> &k) const {
+    return k.zobrist_.value();
+  }
+};
+
+}
+
+#endif /* FUDGE_ZOBRIST_H_ */
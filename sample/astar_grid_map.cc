@@ -6,9 +6,11 @@
 
 // Search shortest path using A* algorithm.
 int main (int argc, char *argv[]) {
+  int w = 0;
+  int h = 0;
   std::vector<double> matrix = fudge::load_matrix<double>(
-      "../data/matrix_10x10_wall.txt");
-  fudge::GridMap<double> map(10, 10, matrix);
+      "../data/matrix_10x10_wall.txt", w, h);
+  fudge::GridMap<double> map(w, h, matrix);
 
   PREPARE_TIMER
   START_TIMER
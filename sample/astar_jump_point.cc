@@ -6,10 +6,12 @@
 
 // Search shortest path using Jump Point Search algorithm.
 int main (int argc, char *argv[]) {
+  int w = 0;
+  int h = 0;
   std::vector<double> matrix = fudge::load_matrix<double>(
-      "../data/matrix_10x10_wall.txt");
+      "../data/matrix_10x10_wall.txt", w, h);
 
-  fudge::JumpPointMap<double> map(10, 10, matrix);
+  fudge::JumpPointMap<double> map(w, h, matrix);
   fudge::Coord start(7, 0);
   fudge::Coord goal(4, 1);
   map.goal_ = goal; // This is needed for checking Jump Point.
@@ -33,10 +33,12 @@ void print_result(const std::vector<const MultiAgentNode*> &path,
 // 6 agents in 2 groups find paths with different speed in a 10x10 map with
 // obstacles. All agents except the first one of each group have predecessors.
 int main (int argc, char *argv[]) {
+  int w = 0;
+  int h = 0;
   std::vector<int> matrix = fudge::load_matrix<int>(
-      "../data/matrix_10x10_agents.txt");
+      "../data/matrix_10x10_agents.txt", w, h);
 
-  MultiAgentMap map(10, 10, matrix, 1);
+  MultiAgentMap map(w, h, matrix, 1);
 
   auto start = MultiAgentNode::create({}, {},
       {Agent(0, Pos(0, 0), Pos(9, 9), 3),
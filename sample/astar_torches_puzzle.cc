@@ -4,11 +4,15 @@
 #include "astar_search.h"
 #include "util/time_util.h"
 #include "torches_puzzle.h"
+#include "xor_search.h"
 
 // There are 7 torches. Each one controls another two torches. 
 // Each turn the state of a torch and torches under its control are toggled. 
 // Assume at the beginning there are two torches that have been turned on and 
 // others are turned off. Try to find the least steps to turn on all torches.
+//
+// Then the same is done for 30 torches, with torches as bits of a word and
+// every state visited kept in a bitset.
 int main (int argc, char *argv[]) {
   // Set initial state.
   TorchesPosition start({
@@ -44,5 +48,27 @@ int main (int argc, char *argv[]) {
     std::cout << i->to_string() << " --- " << i->cost_ << std::endl;
   std::cout << map.stats_.to_string() << std::endl;
 
+  // Torch i controls torches i + 1 and 5i + 2.
+  const int n = 30;
+  std::vector<Torch> torches;
+  for (int i = 0; i < n; i++)
+    torches.push_back(Torch {(i + 1) % n, (i * 5 + 2) % n});
+  const BitTorchesPuzzle bit_map(torches);
+  fudge::XorSearch search(bit_map.masks(), n);
+
+  START_TIMER
+  const bool found = search.search(0x3, (uint64_t(1) << n) - 1);
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  if (found) {
+    const std::vector<uint64_t> bit_path = search.path();
+    for (auto i = bit_path.rbegin(); i != bit_path.rend(); ++i)
+      std::cout << BitTorchesPosition(*i, n).to_string() << std::endl;
+  } else {
+    std::cout << "No solution" << std::endl;
+  }
+  std::cout << "  nodes visited:" << search.nodes_visited() << std::endl;
+
   return 0;
 }
@@ -3,6 +3,7 @@
 #include <iostream>
 #include "water_jug_map.h"
 #include "astar_search.h"
+#include "breadth_first_search.h"
 #include "util/time_util.h"
 
 // There are 4 jugs with maximal capacity of 21, 15, 8, and 5 liter each.
@@ -11,6 +12,8 @@
 // Initially only the first jug has 21 liter of water. Other jugs are empty.
 // We want to reach the target state that 4 jugs have 7, 7, 7, and 0 liter of
 // water each.
+// Every pour counts as one move, so a breadth first search finds the same
+// path without a priority queue. It's run after A* for comparison.
 int main (int argc, char *argv[]) {
   WaterJugMap map(std::vector<int>{21, 15, 8, 5});
 
@@ -31,5 +34,24 @@ int main (int argc, char *argv[]) {
     std::cout << i->to_string() << " --- " << i->cost_ << std::endl;
   std::cout << map.stats_.to_string() << std::endl;
 
+  WaterJugMap bfs_map(std::vector<int>{21, 15, 8, 5});
+  fudge::BreadthFirstSearch<WaterJugMap> bfs(bfs_map);
+
+  START_TIMER
+  const std::vector<WaterJugPosition> bfs_path = bfs.search(
+      WaterJugPosition({21, 0, 0, 0}), WaterJugPosition({7, 7, 7, 0}));
+  END_TIMER
+  std::cout << "Breadth first search, " << bfs_path.size() - 1 << " moves, "
+            << bfs.nodes_held() << " nodes held" << std::endl;
+  PRINT_TIME_ELAPSED
+
+  START_TIMER
+  const std::vector<WaterJugPosition> frontier_path = bfs.frontier_search(
+      WaterJugPosition({21, 0, 0, 0}), WaterJugPosition({7, 7, 7, 0}));
+  END_TIMER
+  std::cout << "Frontier search, " << frontier_path.size() - 1 << " moves, "
+            << bfs.nodes_held() << " nodes held" << std::endl;
+  PRINT_TIME_ELAPSED
+
   return 0;
 }
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "grid_map.h"
+#include "astar_search.h"
+#include "util/perf_counter.h"
+
+// Compare the storage layouts of GridMap on a 2048x2048 map. The same queries
+// are searched with each layout. Time and hardware cache misses are measured
+// around the searches only. Cache misses are reported as n/a if performance
+// counters are not available, like in most containers.
+
+static const int kWidth = 2048;
+static const int kHeight = 2048;
+static const int kQueries = 8;
+
+class Result {
+public:
+  double time_ms_ = 0;
+  long expansions_ = 0;
+  double cost_ = 0;
+  uint64_t cache_misses_ = 0;
+  uint64_t l1d_misses_ = 0;
+};
+
+template <typename Layout>
+Result run(const std::vector<double> &matrix,
+           const std::vector<std::pair<fudge::Coord, fudge::Coord>> &queries) {
+  Result r;
+  fudge::PerfCounter cache_misses(fudge::PerfCounter::kHardware,
+                                  fudge::PerfCounter::kCacheMisses);
+  fudge::PerfCounter l1d_misses(fudge::PerfCounter::kHardwareCache,
+                                fudge::PerfCounter::kL1DataReadMisses);
+  const fudge::VertexMatrix<double, Layout> vertex_matrix(kWidth, kHeight,
+                                                          matrix);
+
+  for (const auto &q : queries) {
+    fudge::GridMap<double, Layout> map(vertex_matrix);
+
+    auto begin = std::chrono::steady_clock::now();
+    cache_misses.start();
+    l1d_misses.start();
+    fudge::astar_search(map, q.first, q.second,
+                        fudge::GridMap<double>::diagonal_distance);
+    l1d_misses.stop();
+    cache_misses.stop();
+    auto end = std::chrono::steady_clock::now();
+
+    r.time_ms_ += std::chrono::duration<double, std::milli>(end - begin)
+        .count();
+    r.expansions_ += map.stats_.nodes_closed;
+    r.cost_ += map.node(q.second)->g_;
+    r.cache_misses_ += cache_misses.value();
+    r.l1d_misses_ += l1d_misses.value();
+  }
+
+  if (!cache_misses.is_open())
+    r.cache_misses_ = 0;
+  if (!l1d_misses.is_open())
+    r.l1d_misses_ = 0;
+  return r;
+}
+
+void print(const char *name, const Result &r, bool counters) {
+  std::string misses = "n/a";
+  std::string l1d = "n/a";
+  if (counters) {
+    misses = std::to_string(r.cache_misses_);
+    l1d = std::to_string(r.l1d_misses_);
+  }
+  printf("%-12s %10.1f %12ld %14.2f %14s %14s\n", name, r.time_ms_,
+         r.expansions_, r.cost_, misses.c_str(), l1d.c_str());
+}
+
+int main (int argc, char *argv[]) {
+  // Weights from 1 to 4 with 20% of obstacles.
+  std::mt19937 rng(2048);
+  std::uniform_int_distribution<int> weight(-1, 3);
+  std::vector<double> matrix(kWidth * kHeight);
+  for (double &v : matrix) {
+    int w = weight(rng);
+    v = w < 0 ? -1 : w + 1;
+  }
+
+  std::uniform_int_distribution<int> coord(0, kWidth - 1);
+  std::vector<std::pair<fudge::Coord, fudge::Coord>> queries;
+  while (static_cast<int>(queries.size()) < kQueries) {
+    fudge::Coord s(coord(rng), coord(rng));
+    fudge::Coord g(coord(rng), coord(rng));
+    if (matrix[s.second * kWidth + s.first] > 0
+        && matrix[g.second * kWidth + g.first] > 0)
+      queries.push_back(std::make_pair(s, g));
+  }
+
+  fudge::PerfCounter probe(fudge::PerfCounter::kHardware,
+                           fudge::PerfCounter::kCacheMisses);
+  const bool counters = probe.is_open();
+
+  printf("%d queries on %dx%d\n", kQueries, kWidth, kHeight);
+  printf("%-12s %10s %12s %14s %14s %14s\n", "layout", "time(ms)",
+         "expansions", "total cost", "cache misses", "L1D misses");
+  print("row-major", run<fudge::RowMajorLayout>(matrix, queries), counters);
+  print("blocked 8", run<fudge::BlockedLayout<8>>(matrix, queries), counters);
+  print("blocked 16", run<fudge::BlockedLayout<16>>(matrix, queries),
+        counters);
+  print("morton", run<fudge::MortonLayout>(matrix, queries), counters);
+
+  return 0;
+}
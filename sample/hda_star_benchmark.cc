@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "sliding_puzzle_map.h"
+#include "astar_search.h"
+#include "hda_star_search.h"
+
+// Solve 4x4 puzzles with linear conflict by A* and by HDA* on 1, 2, 4 ...
+// threads, up to the count given or the count of cores.
+//
+// Usage: hda_star_benchmark [max threads]
+
+static const char *kGoal = "123456789abcdef0";
+static const char *kPuzzles[] = {
+  "1278d3a4b9e56cf0", // 40 moves
+  "620bfec3d1475a98", // 46 moves
+  "1d79e564f3cba820", // 48 moves
+};
+
+typedef std::function<int(const PackedSlidingPosition &,
+                          const PackedSlidingPosition &)> Heuristic;
+
+int main (int argc, char *argv[]) {
+  const int max_threads = argc > 1 ? atoi(argv[1])
+      : std::max(1u, std::thread::hardware_concurrency());
+
+  PackedSlidingPuzzleMap map(4);
+  const Heuristic heuristic = std::bind(
+      &PackedSlidingPuzzleMap::linear_conflict, &map,
+      std::placeholders::_1, std::placeholders::_2);
+
+  for (const char *puzzle : kPuzzles) {
+    printf("\n%s\n", puzzle);
+    printf("%-10s %10s %12s %8s\n", "threads", "time(ms)", "expansions",
+           "moves");
+
+    PackedSlidingPuzzleMap map0(4);
+    auto begin = std::chrono::steady_clock::now();
+    const std::vector<PackedSlidingPosition> path0 = fudge::astar_search(map0,
+        PackedSlidingPosition(puzzle), PackedSlidingPosition(kGoal), heuristic);
+    auto end = std::chrono::steady_clock::now();
+    printf("%-10s %10.1f %12d %8d\n", "a*",
+           std::chrono::duration<double, std::milli>(end - begin).count(),
+           map0.stats_.nodes_closed, static_cast<int>(path0.size()) - 1);
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+      fudge::HdaStarSearch<PackedSlidingPuzzleMap, Heuristic> search(
+          map, heuristic, threads);
+      begin = std::chrono::steady_clock::now();
+      const std::vector<PackedSlidingPosition> path = search.search(
+          PackedSlidingPosition(puzzle), PackedSlidingPosition(kGoal));
+      end = std::chrono::steady_clock::now();
+      printf("%-10d %10.1f %12zu %8d\n", threads,
+             std::chrono::duration<double, std::milli>(end - begin).count(),
+             search.nodes_expanded(), static_cast<int>(path.size()) - 1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "grid_map.h"
+#include "jump_point_map.h"
+#include "astar_search.h"
+#include "moving_ai.h"
+
+// Run all problems of a Moving AI ".scen" file with GridMap and JumpPointMap,
+// and report time and expansions for each bucket. The optimal lengths of the
+// scenarios forbid cutting corners of obstacles, so GridMap keeps corners
+// whole and its path costs are validated against them. JumpPointMap cuts
+// corners, so its path costs are validated against those of a GridMap
+// cutting corners too. A path "shorter" or "longer" than expected is an
+// error, and so is one not found, which makes the exit status 1.
+//
+// Usage: moving_ai_benchmark [scenario file] [map directory]
+// The map directory defaults to the directory of the scenario file.
+
+// Result of a search.
+class Run {
+public:
+  double time_us_ = 0;
+  int expansions_ = 0;
+  double cost_ = -1;
+};
+
+// Results of the problems in a bucket.
+class Bucket {
+public:
+  std::vector<Run> runs_;
+  int matched_ = 0;
+  int shorter_ = 0;
+  int longer_ = 0;
+  int failed_ = 0;
+
+public:
+  void add(const Run &run, double optimal_length) {
+    runs_.push_back(run);
+    double tolerance = 1e-4 * optimal_length + 1e-3;
+    if (run.cost_ < 0)
+      ++failed_;
+    else if (run.cost_ < optimal_length - tolerance)
+      ++shorter_;
+    else if (run.cost_ > optimal_length + tolerance)
+      ++longer_;
+    else
+      ++matched_;
+  }
+
+  int errors() const {
+    return shorter_ + longer_ + failed_;
+  }
+
+  void print(int bucket) const {
+    std::vector<double> times;
+    double total_time = 0;
+    double total_expansions = 0;
+    for (const Run &run : runs_) {
+      times.push_back(run.time_us_);
+      total_time += run.time_us_;
+      total_expansions += run.expansions_;
+    }
+    std::sort(times.begin(), times.end());
+
+    printf("%6d %6zu %10.1f %10.1f %10.1f %10.1f %12.1f %7d %7d %7d %7d\n",
+           bucket, runs_.size(), total_time / runs_.size(),
+           percentile(times, 0.5), percentile(times, 0.95), times.back(),
+           total_expansions / runs_.size(),
+           matched_, shorter_, longer_, failed_);
+  }
+
+private:
+  static double percentile(const std::vector<double> &sorted, double p) {
+    std::size_t i = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(std::max<std::size_t>(i, 1), sorted.size()) - 1];
+  }
+};
+
+// Search a problem and measure it.
+template <typename MapType>
+Run measure(MapType &map, const fudge::MovingAIScenario &s) {
+  Run r;
+  auto begin = std::chrono::steady_clock::now();
+  const std::vector<fudge::Coord> path = fudge::astar_search(
+      map, s.start_, s.goal_, fudge::GridMap<double>::diagonal_distance);
+  auto end = std::chrono::steady_clock::now();
+
+  r.time_us_ = std::chrono::duration<double, std::micro>(end - begin).count();
+  r.expansions_ = map.stats_.nodes_closed;
+  if (!path.empty() || s.start_ == s.goal_)
+    r.cost_ = map.node(s.goal_)->g_;
+  return r;
+}
+
+// Print the buckets and return the count of errors.
+int print_buckets(const std::string &name,
+                  const std::map<int, Bucket> &buckets) {
+  std::cout << name << std::endl;
+  printf("%6s %6s %10s %10s %10s %10s %12s %7s %7s %7s %7s\n",
+         "bucket", "count", "mean(us)", "p50(us)", "p95(us)", "max(us)",
+         "expansions", "matched", "shorter", "longer", "failed");
+  int errors = 0;
+  for (auto &b : buckets) {
+    b.second.print(b.first);
+    errors += b.second.errors();
+  }
+  std::cout << std::endl;
+  return errors;
+}
+
+int main (int argc, char *argv[]) {
+  std::string scenario_file = argc > 1 ? argv[1]
+      : "../data/moving_ai_16x16.map.scen";
+  std::string map_dir;
+  if (argc > 2) {
+    map_dir = std::string(argv[2]) + "/";
+  } else {
+    std::size_t slash = scenario_file.find_last_of('/');
+    if (slash != std::string::npos)
+      map_dir = scenario_file.substr(0, slash + 1);
+  }
+
+  const std::vector<fudge::MovingAIScenario> scenarios =
+      fudge::load_moving_ai_scenarios(scenario_file);
+  if (scenarios.empty())
+    return 1;
+
+  std::map<std::string, std::vector<double>> matrices;
+  std::map<int, Bucket> grid_buckets;
+  std::map<int, Bucket> jump_point_buckets;
+
+  for (const fudge::MovingAIScenario &s : scenarios) {
+    if (matrices.find(s.map_) == matrices.end()) {
+      int w = 0;
+      int h = 0;
+      matrices[s.map_] = fudge::load_moving_ai_map<double>(
+          map_dir + s.map_, w, h);
+      if (w != s.map_width_ || h != s.map_height_) {
+        ERROR("Map %s is %dx%d but %dx%d is expected.", s.map_.c_str(), w, h,
+              s.map_width_, s.map_height_);
+        return 1;
+      }
+    }
+    std::vector<double> &matrix = matrices[s.map_];
+
+    fudge::GridMap<double> grid_map(s.map_width_, s.map_height_, matrix);
+    grid_map.enable_corner_cutting(false);
+    grid_buckets[s.bucket_].add(measure(grid_map, s), s.optimal_length_);
+
+    fudge::GridMap<double> reference_map(s.map_width_, s.map_height_, matrix);
+    const double reference_length = measure(reference_map, s).cost_;
+    fudge::JumpPointMap<double> jump_point_map(s.map_width_, s.map_height_,
+                                               matrix);
+    jump_point_map.goal_ = s.goal_;
+    jump_point_buckets[s.bucket_].add(measure(jump_point_map, s),
+                                      reference_length);
+  }
+
+  int errors = print_buckets("GridMap", grid_buckets);
+  errors += print_buckets("JumpPointMap (corners cut)", jump_point_buckets);
+
+  return errors == 0 ? 0 : 1;
+}
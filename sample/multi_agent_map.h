@@ -19,6 +19,9 @@
 #include "priority_queue_stl.h"
 #include "edge.h"
 #include "rra.h"
+#include "shared_rra.h"
+#include "all_pairs_table.h"
+#include "zobrist.h"
 
 // Use uint_8 based on the assumption that the maximal map dimension is 256x256.
 using Pos = std::pair<uint8_t, uint8_t>;
@@ -165,25 +168,35 @@ public:
   // Generate a hash code for indexing. The code is not unique. Therefore, it
   // might collide with others. An instance equal check should be performed
   // when the collision happens.
+  //
+  // The code is a Zobrist hash: the XOR of the keys of planned moves and
+  // unplanned agents, so the order of unplanned agents doesn't matter.
+  // Successors update the code of their parent with the keys changed rather
+  // than calling this.
   const std::size_t hash() {
-    std::size_t code =0;
-
-    for (const Move &move : planned_) {
-      code = (code * 31 ) + move.hash();
-    }
-
-    std::deque<Agent> v = unplanned_;
-    std::sort(v.begin(), v.end(), [](const Agent &a, const Agent &b) {
-      return a.id_ < b.id_;
-    });
-
-    for (const Agent &a : v) {
-      code = code * 31 +  a.hash();
-    }
+    uint64_t code = 0;
+    for (const Move &move : planned_)
+      code ^= key(move);
+    for (const Agent &a : unplanned_)
+      code ^= key(a);
     hash_ = code;
     return code;
   }
 
+  // Zobrist key of an unplanned agent. Fields are widened before shifting.
+  static uint64_t key(const Agent &a) {
+    return fudge::zobrist_key(a.id_, (uint64_t(a.cd_) << 32)
+        | (uint64_t(a.pos_.first) << 16) | uint64_t(a.pos_.second));
+  }
+
+  // Zobrist key of a planned move, apart from those of agents.
+  static uint64_t key(const Move &m) {
+    const Agent &a = m.agent_;
+    return fudge::zobrist_key(256 + a.id_, (uint64_t(a.cd_) << 48)
+        | (uint64_t(a.pos_.first) << 36) | (uint64_t(a.pos_.second) << 24)
+        | (uint64_t(m.to_.first) << 12) | uint64_t(m.to_.second));
+  }
+
   // Generate a human friendly string for debug purpose.
   const std::string to_string() const {
     std::ostringstream ss;
@@ -245,6 +258,19 @@ public:
       double weight = 1.0):
     open_list_(), grid_map_(w, h, matrix), rra_(matrix, w, h),
     weight_(weight) {};
+
+  // Share the RRA* costs with other maps and threads on the same matrix.
+  MultiAgentMap(int w, int h, const std::vector<int> &matrix,
+      std::shared_ptr<fudge::SharedRRA<int>> shared_rra,
+      double weight = 1.0):
+    open_list_(), grid_map_(w, h, matrix), rra_(matrix, w, h),
+    shared_rra_(shared_rra), weight_(weight) {};
+
+  // Keep the weights alive, like a snapshot of fudge::VersionedMatrix.
+  MultiAgentMap(const fudge::VertexMatrix<int> &vertex_matrix,
+      double weight = 1.0):
+    open_list_(), grid_map_(vertex_matrix), rra_(vertex_matrix),
+    weight_(weight) {};
   virtual ~MultiAgentMap() = default;
 
 public:
@@ -268,19 +294,51 @@ public:
   int heuristic_rra(const NodeType n0, const NodeType n1) {
     int sum = 0;
     for (auto i = n0->planned_.begin(); i != n0->planned_.end(); ++i) {
-      int d = rra_.search(i->agent_.end_, i->to_,
-          fudge::GridMap<int>::manhattan_distance);
+      int d = distance(i->agent_.end_, i->to_);
       sum += d * i->agent_.speed_;
     }
     for (auto i = n0->unplanned_.begin(); i != n0->unplanned_.end(); ++i) {
       Agent a = *i;
-      int d = rra_.search(a.end_, a.pos_, 
-                          fudge::GridMap<int>::manhattan_distance);
+      int d = distance(a.end_, a.pos_);
       sum += d * a.speed_;
     }
     return sum * weight_;
   }
 
+  // Use a precomputed table of distances. The table should be built without
+  // diagonal moves since agents only move to the 4 neighbors.
+  int heuristic_table(const NodeType n0, const NodeType) {
+    int sum = 0;
+    for (auto i = n0->planned_.begin(); i != n0->planned_.end(); ++i) {
+      int d = table_->distance(i->to_, i->agent_.end_);
+      sum += d * i->agent_.speed_;
+    }
+    for (auto i = n0->unplanned_.begin(); i != n0->unplanned_.end(); ++i) {
+      Agent a = *i;
+      int d = table_->distance(a.pos_, a.end_);
+      sum += d * a.speed_;
+    }
+    return sum * weight_;
+  }
+
+  void use_distance_table(
+      std::shared_ptr<const fudge::AllPairsTable<int>> table) {
+    table_ = table;
+  }
+
+  // Look obstacles up in a passability bitmap, see fudge::GridMap.
+  void use_passability_bitmap() {
+    grid_map_.use_passability_bitmap();
+  }
+
+  // Call this after the weights in the region are edited in place. The
+  // bitmap takes them, and RRA* costs affected are dropped. Costs shared with
+  // other maps are not.
+  void update(const fudge::CellRegion &region) {
+    grid_map_.update(region);
+    rra_.invalidate(region);
+  }
+
   // The simplest heuristic is the sum of the Manhattan distance of all agents.
   int heuristic_manhattan(const NodeType n0, const NodeType n1) {
     int sum = 0;
@@ -316,11 +374,14 @@ public:
 
       if (is_legal(move, from)) {
         NodeType to = MultiAgentNode::create();
-        // Inherit planned moves and unplanned agents from parent.
+        // Inherit planned moves and unplanned agents from parent, and update
+        // the hash code of parent with the keys changed.
         to->planned_ = from->planned_;
         to->planned_.push_back(move);
+        to->hash_ = from->hash_ ^ MultiAgentNode::key(move);
         to->unplanned_ = from->unplanned_;
         if (!to->unplanned_.empty()) {
+          to->hash_ ^= MultiAgentNode::key(to->unplanned_.front());
           to->unplanned_.pop_front();
         }
 
@@ -336,11 +397,13 @@ public:
             Move &move = to->planned_.front();
             Agent a = move.agent_;
             a.pos_ = move.to_;
+            to->hash_ ^= MultiAgentNode::key(move);
 
             if (a.pos_ != a.start_)
               a.state_ = AgentState::moved;
             if (a.pos_ != a.end_) {
               to->unplanned_.push_back(a);
+              to->hash_ ^= MultiAgentNode::key(a);
             }
             to->planned_.pop_front();
           }
@@ -349,7 +412,6 @@ public:
         --count;
 
         // Generate a new edge.
-        to->hash();
         result.push_back(fudge::Edge<NodeType, int>(from, to, 1));
       }
     }
@@ -399,6 +461,7 @@ public:
 
     // Add this to prevent an expanding node to add multiple times to open list.
     if (is_node_unexplored(n)) {
+      count_collisions(nn);
       map_.emplace(nn, nn);
     }
 
@@ -485,9 +548,28 @@ private:
   fudge::GridMap<int> grid_map_;
   std::unordered_multimap<NodeType, NodeType, NodeHash, NodeEqual> map_;
   fudge::RRA<int> rra_;
+  std::shared_ptr<fudge::SharedRRA<int>> shared_rra_;
+  std::shared_ptr<const fudge::AllPairsTable<int>> table_;
   double weight_;
 
 private:
+  // Count explored nodes of the same hash code as a new node.
+  void count_collisions(const NodeType &n) {
+    const std::size_t b = map_.bucket(n);
+    for (auto i = map_.begin(b); i != map_.end(b); ++i) {
+      if (i->first->hash_ == n->hash_)
+        ++stats_.hash_collisions;
+    }
+  }
+
+  // Actual distance from the position to the agent's target by RRA*.
+  int distance(const Pos &end, const Pos &pos) {
+    if (shared_rra_)
+      return shared_rra_->search(end, pos,
+                                 fudge::GridMap<int>::manhattan_distance);
+    return rra_.search(end, pos, fudge::GridMap<int>::manhattan_distance);
+  }
+
   std::deque<Move> possible_moves(const Agent &agent) {
     std::deque<Move> moves;
 
@@ -496,12 +578,13 @@ private:
 
     // When an agent's CD reachs zero, it's allowed to move.
     if (agent.cd_ <= 0) {
-      for (auto c: {Pos(x + 1, y), Pos(x - 1, y),
-                    Pos(x, y + 1), Pos(x, y - 1)}){
-        if (grid_map_.vertex_matrix_.is_passable(c)) {
+      // Check coordinates before narrowing, as -1 would wrap around in Pos.
+      for (auto c: {fudge::Coord(x + 1, y), fudge::Coord(x - 1, y),
+                    fudge::Coord(x, y + 1), fudge::Coord(x, y - 1)}){
+        if (grid_map_.is_passable(c)) {
           Agent a = agent;
           a.cd_ = a.speed_ - 1;
-          moves.push_back(Move(a, c));
+          moves.push_back(Move(a, Pos(c.first, c.second)));
         }
       }
     }
@@ -513,12 +596,7 @@ private:
 
     // Sort to expand from the highest possible direction.
     std::sort(moves.begin(), moves.end(), [&](const Move &a, const Move &b) {
-      return (
-        rra_.search(a.agent_.end_, a.to_, 
-                    fudge::GridMap<int>::manhattan_distance)
-        < rra_.search(a.agent_.end_, a.to_, 
-                      fudge::GridMap<int>::manhattan_distance)
-      );
+      return distance(a.agent_.end_, a.to_) < distance(a.agent_.end_, a.to_);
     });
 
     return moves;
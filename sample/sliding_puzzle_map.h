@@ -1,47 +1,108 @@
 #ifndef SLIDING_PUZZLE_MAP_H_
 #define SLIDING_PUZZLE_MAP_H_
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
 #include "position_map.h"
+#include "permutation_rank.h"
+#include "ranked_map.h"
 
-class SlidingPosition : public fudge::Position<char, int, std::string> {
+class SlidingPosition
+  : public fudge::StaticPosition<SlidingPosition, char, int, std::string> {
 public:
   SlidingPosition(const std::string &pos) {
     std::copy(pos.begin(), pos.end(), std::back_inserter(pos_));
   } 
   SlidingPosition() {};
-  virtual ~SlidingPosition() = default;
 
 public:
-  virtual std::string hash() const override {
+  std::string hash() const {
     return std::string(pos_.begin(), pos_.end());
   }
 
-  virtual const std::string to_string() const override {
+  const std::string to_string() const {
     return hash();
   }
 };
 
-class SlidingPuzzleMap : 
-    public fudge::PositionMap<char, SlidingPosition, int, std::string> {
+// A position of up to 16 tiles packed into a 64-bit word, one nibble per
+// cell, with the index of the hole cached. Tiles are given as hex digits and
+// the hole is '0'. Moves are a few bit operations, and the packed word is the
+// hash, so hashing and comparison take a single word. It's trivially
+// copyable.
+class PackedSlidingPosition
+  : public fudge::PositionNode<PackedSlidingPosition, int, uint64_t> {
 public:
-  SlidingPuzzleMap(int w, int h) : PositionMap(), w_(w), h_(h) {
-    open_list_.kc_ = 2;
+  PackedSlidingPosition(const std::string &pos) : size_(pos.size()) {
+    assert(pos.size() <= 16);
+    for (int i = 0; i < size_; i++) {
+      const char c = pos[i];
+      const uint64_t t = c <= '9' ? c - '0' : c - 'a' + 10;
+      tiles_ |= t << (i * 4);
+      if (t == 0)
+        hole_ = i;
+    }
   }
-  explicit SlidingPuzzleMap(int w) : SlidingPuzzleMap(w, w) {};
-  virtual ~SlidingPuzzleMap() = default;
+  PackedSlidingPosition() {};
+
+public:
+  uint64_t tiles_ = 0;
+  int8_t hole_ = 0;
+  int8_t size_ = 0;
+
+public:
+  int tile(int i) const {
+    return (tiles_ >> (i * 4)) & 0xF;
+  }
+
+  // Move the tile at i into the hole.
+  void move(int i) {
+    const uint64_t t = (tiles_ >> (i * 4)) & 0xF;
+    tiles_ = (tiles_ & ~(uint64_t(0xF) << (i * 4))) | (t << (hole_ * 4));
+    hole_ = i;
+  }
+
+  uint64_t hash() const {
+    return tiles_;
+  }
+
+  const std::string to_string() const {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string s(size_, '0');
+    for (int i = 0; i < size_; i++)
+      s[i] = digits[tile(i)];
+    return s;
+  }
+};
+
+// Explored positions are stored in the storage given, see PositionMap.
+template <typename Storage>
+class BasicSlidingPuzzleMap :
+    public fudge::PositionMap<char, SlidingPosition, int, std::string, Storage> {
+public:
+  BasicSlidingPuzzleMap(int w, int h) : w_(w), h_(h) {
+    this->open_list_.kc_ = 2;
+  }
+  explicit BasicSlidingPuzzleMap(int w) : BasicSlidingPuzzleMap(w, w) {};
+  virtual ~BasicSlidingPuzzleMap() = default;
 
 public:
   static constexpr char kHole = '0';
 
 public:
   int manhattan_distance(const SlidingPosition &n0, const SlidingPosition &n1) {
+    int target[256]; // Goal cell of each tile, by its character.
+    for (int i = 0; i < w_ * h_; i++)
+      target[static_cast<unsigned char>(n1.pos_[i])] = i;
+
     int distance = 0;
     for (auto y = 0; y < h_; y++) {
       for (auto x = 0; x < w_; x++) {
         char c = n0.pos_[y * w_ + x];
         if (c != kHole) {
-          int i = std::find(n1.pos_.begin(), n1.pos_.end(), c) 
-              - n1.pos_.begin();
+          const int i = target[static_cast<unsigned char>(c)];
           distance += abs(x - i % w_) + abs(y - i / w_);
         }
       }
@@ -91,6 +152,200 @@ private:
   }
 };
 
-constexpr char SlidingPuzzleMap::kHole;
+template <typename Storage>
+constexpr char BasicSlidingPuzzleMap<Storage>::kHole;
+
+using SlidingPuzzleMap = BasicSlidingPuzzleMap<
+    fudge::FlatHashMap<std::string, SlidingPosition>>;
+
+// Kept for comparison with the flat hash table.
+using OrderedSlidingPuzzleMap = BasicSlidingPuzzleMap<
+    std::map<std::string, SlidingPosition>>;
+
+// The same puzzle on packed positions. Successors are made by moving tiles
+// of a copy of the position, without building any string or vector.
+template <typename Storage>
+class BasicPackedSlidingPuzzleMap :
+    public fudge::PositionMap<char, PackedSlidingPosition, int, uint64_t,
+                              Storage> {
+public:
+  BasicPackedSlidingPuzzleMap(int w, int h) : w_(w), h_(h) {
+    assert(w * h <= 16);
+    this->open_list_.kc_ = 2;
+  }
+  explicit BasicPackedSlidingPuzzleMap(int w)
+    : BasicPackedSlidingPuzzleMap(w, w) {};
+  virtual ~BasicPackedSlidingPuzzleMap() = default;
+
+public:
+  int manhattan_distance(const PackedSlidingPosition &n0,
+                         const PackedSlidingPosition &n1) const {
+    int target[16];
+    for (int i = 0; i < w_ * h_; i++)
+      target[n1.tile(i)] = i;
+
+    int distance = 0;
+    for (int i = 0; i < w_ * h_; i++) {
+      const int t = n0.tile(i);
+      if (t != 0)
+        distance += abs(i % w_ - target[t] % w_) + abs(i / w_ - target[t] / w_);
+    }
+    return distance;
+  }
+
+  // Manhattan distance plus 2 moves for each tile which has to leave its goal
+  // row or column to let other tiles of the line pass. It's admissible, and
+  // much cheaper than pattern databases.
+  int linear_conflict(const PackedSlidingPosition &n0,
+                      const PackedSlidingPosition &n1) const {
+    int target[16];
+    for (int i = 0; i < w_ * h_; i++)
+      target[n1.tile(i)] = i;
+
+    int distance = manhattan_distance(n0, n1);
+    int line[16];
+    for (int y = 0; y < h_; y++) {
+      int m = 0; // Goal columns of tiles in their goal row, from left to right.
+      for (int x = 0; x < w_; x++) {
+        const int t = n0.tile(y * w_ + x);
+        if (t != 0 && target[t] / w_ == y)
+          line[m++] = target[t] % w_;
+      }
+      distance += 2 * line_conflicts(line, m);
+    }
+    for (int x = 0; x < w_; x++) {
+      int m = 0; // Goal rows of tiles in their goal column, from top down.
+      for (int y = 0; y < h_; y++) {
+        const int t = n0.tile(y * w_ + x);
+        if (t != 0 && target[t] % w_ == x)
+          line[m++] = target[t] / w_;
+      }
+      distance += 2 * line_conflicts(line, m);
+    }
+    return distance;
+  }
+
+public:
+  virtual const std::vector<fudge::Edge<PackedSlidingPosition, int>>
+  edges (const PackedSlidingPosition &n) override {
+    std::vector<fudge::Edge<PackedSlidingPosition, int>> es;
+    es.reserve(4);
+    const int x = n.hole_ % w_;
+    const int y = n.hole_ / w_;
+
+    if (x < w_ - 1)
+      push_edge(es, n, n.hole_ + 1); // Move east
+
+    if (x > 0)
+      push_edge(es, n, n.hole_ - 1); // Move west
+
+    if (y < h_ - 1)
+      push_edge(es, n, n.hole_ + w_); // Move south
+
+    if (y > 0)
+      push_edge(es, n, n.hole_ - w_); // Move north
+
+    return es;
+  }
+
+private:
+  int w_ = 0;
+  int h_ = 0;
+
+private:
+  // Count the fewest tiles to take out of a line so that the goals of the
+  // others are in order, which is the length of the line less its longest
+  // increasing subsequence. Taking out the tile in most conflicts first may
+  // take out more on lines of 5 tiles or more.
+  static int line_conflicts(const int *line, int m) {
+    int longest[16]; // Longest increasing subsequence ending at i.
+    int most = 0;
+    for (int i = 0; i < m; i++) {
+      longest[i] = 1;
+      for (int j = 0; j < i; j++) {
+        if (line[j] < line[i])
+          longest[i] = std::max(longest[i], longest[j] + 1);
+      }
+      most = std::max(most, longest[i]);
+    }
+    return m - most;
+  }
+
+  void push_edge(std::vector<fudge::Edge<PackedSlidingPosition, int>> &es,
+                 const PackedSlidingPosition &source, int i) {
+    PackedSlidingPosition position = source;
+    position.move(i);
+    es.push_back(fudge::Edge<PackedSlidingPosition, int>(source, position, 1));
+  }
+};
+
+using PackedSlidingPuzzleMap = BasicPackedSlidingPuzzleMap<
+    fudge::FlatHashMap<uint64_t, PackedSlidingPosition>>;
+
+// The puzzle as a domain of IdaStarSearch, moving a single packed position in
+// place. A move keeps the cell of the tile moved and the hole before it, so
+// it's undone by moving the tile back.
+class PackedSlidingPuzzleDomain {
+public:
+  struct Move {
+    int8_t cell;
+    int8_t hole;
+  };
+  using State = PackedSlidingPosition;
+  using Cost = int;
+
+public:
+  PackedSlidingPuzzleDomain(int w, int h) : w_(w), h_(h) {
+    assert(w * h <= 16);
+  }
+  explicit PackedSlidingPuzzleDomain(int w)
+    : PackedSlidingPuzzleDomain(w, w) {};
+
+public:
+  void moves(const State &s, std::vector<Move> &ms) const {
+    const int x = s.hole_ % w_;
+    const int y = s.hole_ / w_;
+    if (x < w_ - 1)
+      ms.push_back(Move {static_cast<int8_t>(s.hole_ + 1), s.hole_});
+    if (x > 0)
+      ms.push_back(Move {static_cast<int8_t>(s.hole_ - 1), s.hole_});
+    if (y < h_ - 1)
+      ms.push_back(Move {static_cast<int8_t>(s.hole_ + w_), s.hole_});
+    if (y > 0)
+      ms.push_back(Move {static_cast<int8_t>(s.hole_ - w_), s.hole_});
+  }
+
+  int apply(State &s, const Move &m) const {
+    s.move(m.cell);
+    return 1;
+  }
+
+  void undo(State &s, const Move &m) const {
+    s.move(m.hole);
+  }
+
+  bool reverses(const Move &m, const Move &last) const {
+    return m.cell == last.hole;
+  }
+
+  bool nodes_equal(const State &s0, const State &s1) const {
+    return s0.tiles_ == s1.tiles_;
+  }
+
+  uint64_t hash(const State &s) const {
+    return s.tiles_;
+  }
+
+private:
+  int w_ = 0;
+  int h_ = 0;
+};
+
+// Positions of puzzles with kCells cells indexed by permutation rank, without
+// hashing. This suits 3x3 and 2x4 puzzles, which have 9! and 8! positions.
+template <int kCells>
+using RankedSlidingPuzzleMap = BasicPackedSlidingPuzzleMap<
+    fudge::RankedMap<uint64_t, PackedSlidingPosition,
+                     fudge::PackedPermutationRank<kCells>>>;
 
 #endif /* SLIDING_PUZZLE_MAP_H_ */
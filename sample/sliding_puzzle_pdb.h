@@ -0,0 +1,331 @@
+#ifndef SLIDING_PUZZLE_PDB_H_
+#define SLIDING_PUZZLE_PDB_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "binary_map.h"
+#include "util/log.h"
+#include "util/mapped_file.h"
+#include "sliding_puzzle_map.h"
+
+// Pattern databases of sliding puzzles on packed positions.
+//
+// A database is built for a pattern, a set of tiles, and a goal. It keeps the
+// least count of moves of pattern tiles taking them from any placement to
+// their goal cells, found by a breadth first search backwards from the goal.
+// Moves of other tiles are free, so databases of disjoint patterns could be
+// added up and stay admissible.
+//
+// The count is never less than the Manhattan distance of the pattern tiles,
+// and has the same parity. Only half the difference is stored, in a nibble,
+// so a 5 tile database of a 4x4 puzzle takes 256KB. Differences too large for
+// a nibble are capped, which keeps the heuristic admissible.
+//
+// A database is saved as a 64 bytes header followed by the nibbles, and could
+// be used in place from a memory mapped file.
+
+struct SlidingPdbHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  int32_t width;
+  int32_t height;
+  uint64_t goal;           // Packed goal position.
+  uint32_t tiles;          // Bit set of pattern tiles.
+  uint32_t reserved;
+  uint64_t payload_size;
+  uint64_t checksum;       // FNV-1a of the payload.
+  uint8_t padding[8];
+};
+
+static_assert(sizeof(SlidingPdbHeader) == 64, "Unexpected header size.");
+
+static constexpr char kSlidingPdbMagic[8] {'F','U','D','G','E','P','D','B'};
+static constexpr uint32_t kSlidingPdbVersion = 1;
+
+class SlidingPatternDatabase {
+public:
+  // Build the database of the tiles. The hole should not be one of them.
+  SlidingPatternDatabase(int w, int h, const PackedSlidingPosition &goal,
+                         const std::vector<int> &tiles)
+    : w_(w), h_(h), goal_(goal.tiles_) {
+    for (int t : tiles)
+      tiles_.push_back(t);
+    init();
+    build(goal.hole_);
+  }
+
+  // Load a database saved by save(). The file is mapped, not read.
+  explicit SlidingPatternDatabase(const std::string &filename)
+    : file_(new fudge::MappedFile(filename)) {
+    if (!file_->is_open()) {
+      ERROR("File not found: %s", filename.c_str());
+      return;
+    }
+
+    SlidingPdbHeader header;
+    if (file_->size() < sizeof(header)) {
+      ERROR("Invalid pattern database: %s", filename.c_str());
+      return;
+    }
+    std::memcpy(&header, file_->data(), sizeof(header));
+    if (std::memcmp(header.magic, kSlidingPdbMagic, sizeof(header.magic)) != 0
+        || header.version != kSlidingPdbVersion
+        || header.width <= 0 || header.height <= 0
+        || header.width * header.height > 16) {
+      ERROR("Invalid pattern database: %s", filename.c_str());
+      return;
+    }
+
+    w_ = header.width;
+    h_ = header.height;
+    goal_ = header.goal;
+    for (int t = 1; t < 16; t++) {
+      if (header.tiles & (1u << t))
+        tiles_.push_back(t);
+    }
+    init();
+
+    if (header.payload_size != (size_ + 1) / 2
+        || header.header_size + header.payload_size > file_->size()) {
+      ERROR("Truncated pattern database: %s", filename.c_str());
+      return;
+    }
+    data_ = reinterpret_cast<const uint8_t *>(file_->data()
+                                              + header.header_size);
+    checksum_ = header.checksum;
+  }
+
+  virtual ~SlidingPatternDatabase() = default;
+
+public:
+  bool is_open() const {
+    return data_ != nullptr;
+  }
+
+  // Return the count of moves of pattern tiles needed, given the cell of
+  // each tile of a position.
+  int lookup(const int cell_of[16]) const {
+    int cells[16];
+    int distance = 0;
+    for (std::size_t i = 0; i < tiles_.size(); i++) {
+      cells[i] = cell_of[tiles_[i]];
+      distance += manhattan(cells[i], target_[i]);
+    }
+    const uint64_t index = index_of(cells);
+    return distance + 2 * ((data_[index >> 1] >> ((index & 1) * 4)) & 0xF);
+  }
+
+  int lookup(const PackedSlidingPosition &p) const {
+    int cell_of[16];
+    for (int i = 0; i < n_; i++)
+      cell_of[p.tile(i)] = i;
+    return lookup(cell_of);
+  }
+
+  bool save(const std::string &filename) const {
+    SlidingPdbHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSlidingPdbMagic, sizeof(header.magic));
+    header.version = kSlidingPdbVersion;
+    header.header_size = sizeof(header);
+    header.width = w_;
+    header.height = h_;
+    header.goal = goal_;
+    for (int t : tiles_)
+      header.tiles |= 1u << t;
+    header.payload_size = (size_ + 1) / 2;
+    header.checksum = fudge::fnv1a(data_, header.payload_size);
+
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open()) {
+      ERROR("Failed to open %s for writing.", filename.c_str());
+      return false;
+    }
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char *>(data_), header.payload_size);
+    return ofs.good();
+  }
+
+  bool verify() const {
+    return is_open() && (file_ == nullptr
+        || fudge::fnv1a(data_, (size_ + 1) / 2) == checksum_);
+  }
+
+  // Count of placements of the pattern tiles.
+  uint64_t size() const {
+    return size_;
+  }
+
+  std::size_t memory_usage() const {
+    return (size_ + 1) / 2;
+  }
+
+private:
+  int w_ = 0;
+  int h_ = 0;
+  int n_ = 0;
+  uint64_t goal_ = 0;
+  std::vector<int> tiles_;
+  std::vector<int> target_;     // Goal cell of each pattern tile.
+  uint64_t size_ = 0;
+  const uint8_t *data_ = nullptr;
+  std::vector<uint8_t> nibbles_; // Owned data if built.
+  std::unique_ptr<fudge::MappedFile> file_;
+  uint64_t checksum_ = 0;
+
+private:
+  void init() {
+    n_ = w_ * h_;
+    size_ = 1;
+    target_.clear();
+    for (std::size_t i = 0; i < tiles_.size(); i++) {
+      size_ *= n_ - i;
+      for (int c = 0; c < n_; c++) {
+        if (static_cast<int>((goal_ >> (c * 4)) & 0xF) == tiles_[i])
+          target_.push_back(c);
+      }
+    }
+  }
+
+  int manhattan(int c0, int c1) const {
+    return abs(c0 % w_ - c1 % w_) + abs(c0 / w_ - c1 / w_);
+  }
+
+  struct State {
+    int8_t cells[16]; // Cell of each pattern tile.
+    int8_t hole;
+  };
+
+  // Index of a placement, given the cell of each pattern tile.
+  template <typename CellType>
+  uint64_t index_of(const CellType *cells) const {
+    uint64_t index = 0;
+    uint32_t used = 0;
+    for (std::size_t i = 0; i < tiles_.size(); i++) {
+      const int c = cells[i];
+      index = index * (n_ - i) + c - __builtin_popcount(used & ((1u << c) - 1));
+      used |= 1u << c;
+    }
+    return index;
+  }
+
+  // A breadth first search on placements of the pattern tiles together with
+  // the hole. Moving the hole over another tile costs nothing, so those
+  // states are searched first (0-1 BFS). The value of a placement is the
+  // least cost over all cells of the hole.
+  void build(int goal_hole) {
+    const int k = tiles_.size();
+    std::vector<uint8_t> cost(size_ * n_, 0xFF);
+    std::vector<uint8_t> best(size_, 0xFF);
+
+    std::deque<State> open;
+    State s0;
+    for (int i = 0; i < k; i++)
+      s0.cells[i] = target_[i];
+    s0.hole = goal_hole;
+    cost[index_of(s0.cells) * n_ + s0.hole] = 0;
+    open.push_back(s0);
+
+    while (!open.empty()) {
+      const State s = open.front();
+      open.pop_front();
+      const uint64_t placement = index_of(s.cells);
+      const uint8_t g = cost[placement * n_ + s.hole];
+      if (g < best[placement])
+        best[placement] = g;
+
+      const int x = s.hole % w_;
+      const int y = s.hole / w_;
+      const int moves[4] {
+          x < w_ - 1 ? s.hole + 1 : -1, x > 0 ? s.hole - 1 : -1,
+          y < h_ - 1 ? s.hole + w_ : -1, y > 0 ? s.hole - w_ : -1};
+      for (int c : moves) {
+        if (c < 0)
+          continue;
+
+        State t = s;
+        t.hole = c;
+        int moved = 0;
+        for (int i = 0; i < k; i++) {
+          if (t.cells[i] == c) {
+            t.cells[i] = s.hole;
+            moved = 1;
+          }
+        }
+
+        const uint64_t j = index_of(t.cells) * n_ + t.hole;
+        if (g + moved < cost[j]) {
+          cost[j] = g + moved;
+          if (moved)
+            open.push_back(t);
+          else
+            open.push_front(t);
+        }
+      }
+    }
+
+    nibbles_.assign((size_ + 1) / 2, 0);
+    int cells[16];
+    for (uint64_t i = 0; i < size_; i++) {
+      unrank(i, cells);
+      int md = 0;
+      for (int t = 0; t < k; t++)
+        md += manhattan(cells[t], target_[t]);
+      const int extra = std::min(15, (best[i] - md) / 2);
+      nibbles_[i >> 1] |= extra << ((i & 1) * 4);
+    }
+    data_ = nibbles_.data();
+  }
+
+  void unrank(uint64_t index, int *cells) const {
+    const int k = tiles_.size();
+    int digits[16];
+    for (int i = k - 1; i >= 0; i--) {
+      digits[i] = index % (n_ - i);
+      index /= (n_ - i);
+    }
+
+    uint32_t unused = (1u << n_) - 1;
+    for (int i = 0; i < k; i++) {
+      uint32_t u = unused;
+      for (int d = 0; d < digits[i]; d++)
+        u &= u - 1;
+      cells[i] = __builtin_ctz(u);
+      unused &= ~(1u << cells[i]);
+    }
+  }
+};
+
+// Heuristic adding up disjoint pattern databases, for astar_search. The goal
+// given is ignored, as the databases are built for their goal.
+class PatternDatabaseHeuristic {
+public:
+  PatternDatabaseHeuristic(
+      const std::vector<std::shared_ptr<const SlidingPatternDatabase>> &pdbs)
+    : pdbs_(pdbs) {};
+
+public:
+  int operator ()(const PackedSlidingPosition &n0,
+                  const PackedSlidingPosition &) const {
+    int cell_of[16];
+    for (int i = 0; i < n0.size_; i++)
+      cell_of[n0.tile(i)] = i;
+
+    int h = 0;
+    for (const auto &pdb : pdbs_)
+      h += pdb->lookup(cell_of);
+    return h;
+  }
+
+private:
+  std::vector<std::shared_ptr<const SlidingPatternDatabase>> pdbs_;
+};
+
+#endif /* SLIDING_PUZZLE_PDB_H_ */
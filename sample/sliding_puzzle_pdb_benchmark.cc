@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sliding_puzzle_pdb.h"
+#include "astar_search.h"
+#include "ida_star_search.h"
+
+// Solve 4x4 puzzles with A* and compare heuristics: Manhattan distance,
+// linear conflict and additive 5-5-5 pattern databases. Searches with a weak
+// heuristic are skipped once they open too many nodes. IDA* with the pattern
+// databases is run too, which keeps no nodes.
+//
+// Usage: sliding_puzzle_pdb_benchmark [database directory]
+// Databases are loaded from the directory if they are there, or built and
+// saved there otherwise.
+
+static const char *kGoal = "123456789abcdef0";
+static const char *kPuzzles[] = {
+  "1234e5680a7c9dbf", // 12 moves
+  "6403217b5de8a9cf", // 34 moves
+  "1278d3a4b9e56cf0", // 40 moves
+  "620bfec3d1475a98", // 46 moves
+  "1d79e564f3cba820", // 48 moves
+  "184ac0df6953be27", // 50 moves
+};
+static const std::size_t kMaxNodes = 2000000;
+
+// Stop searching by making every node look like the goal once the map holds
+// too many nodes. The path found then is discarded.
+class LimitedMap : public PackedSlidingPuzzleMap {
+public:
+  LimitedMap() : PackedSlidingPuzzleMap(4) {};
+
+public:
+  bool gave_up_ = false;
+
+  virtual bool nodes_equal(const PackedSlidingPosition &n0,
+                           const PackedSlidingPosition &n1) const override {
+    if (map_.size() > kMaxNodes) {
+      const_cast<LimitedMap *>(this)->gave_up_ = true;
+      return true;
+    }
+    return PackedSlidingPuzzleMap::nodes_equal(n0, n1);
+  }
+};
+
+template <typename Heuristic>
+void run(const char *name, const char *puzzle, Heuristic heuristic) {
+  LimitedMap map;
+  auto begin = std::chrono::steady_clock::now();
+  const std::vector<PackedSlidingPosition> path = fudge::astar_search(map,
+      PackedSlidingPosition(puzzle), PackedSlidingPosition(kGoal), heuristic);
+  auto end = std::chrono::steady_clock::now();
+
+  if (map.gave_up_) {
+    printf("%-10s %10s %12s %8s\n", name, "-", ">2000000", "-");
+    return;
+  }
+  printf("%-10s %10.1f %12d %8d\n", name,
+         std::chrono::duration<double, std::milli>(end - begin).count(),
+         map.stats_.nodes_closed, static_cast<int>(path.size()) - 1);
+}
+
+template <typename Heuristic>
+void run_ida(const char *name, const char *puzzle, Heuristic heuristic) {
+  PackedSlidingPuzzleDomain domain(4);
+  fudge::IdaStarSearch<PackedSlidingPuzzleDomain, Heuristic> search(
+      domain, heuristic);
+  auto begin = std::chrono::steady_clock::now();
+  search.search(PackedSlidingPosition(puzzle), PackedSlidingPosition(kGoal));
+  auto end = std::chrono::steady_clock::now();
+  printf("%-10s %10.1f %12lu %8d\n", name,
+         std::chrono::duration<double, std::milli>(end - begin).count(),
+         static_cast<unsigned long>(search.nodes_expanded()), search.cost());
+}
+
+int main (int argc, char *argv[]) {
+  const std::string dir = argc > 1 ? argv[1] : ".";
+  const std::vector<std::vector<int>> patterns {
+      {1, 2, 3, 5, 6}, {4, 7, 8, 11, 12}, {9, 10, 13, 14, 15}};
+
+  std::vector<std::shared_ptr<const SlidingPatternDatabase>> pdbs;
+  for (std::size_t i = 0; i < patterns.size(); i++) {
+    const std::string filename = dir + "/pdb_4x4_" + std::to_string(i) + ".pdb";
+    auto begin = std::chrono::steady_clock::now();
+    std::shared_ptr<SlidingPatternDatabase> pdb(
+        new SlidingPatternDatabase(filename));
+    const bool loaded = pdb->is_open() && pdb->verify();
+    if (!loaded) {
+      pdb.reset(new SlidingPatternDatabase(4, 4, PackedSlidingPosition(kGoal),
+                                           patterns[i]));
+      pdb->save(filename);
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("%s %s in %.1f ms (%zu bytes)\n", loaded ? "Loaded" : "Built",
+           filename.c_str(),
+           std::chrono::duration<double, std::milli>(end - begin).count(),
+           pdb->memory_usage());
+    pdbs.push_back(pdb);
+  }
+
+  PackedSlidingPuzzleMap map(4);
+  const PatternDatabaseHeuristic pdb_heuristic(pdbs);
+  for (const char *puzzle : kPuzzles) {
+    printf("\n%s\n", puzzle);
+    printf("%-10s %10s %12s %8s\n", "heuristic", "time(ms)", "expansions",
+           "moves");
+    run("manhattan", puzzle, std::bind(
+        &PackedSlidingPuzzleMap::manhattan_distance, &map,
+        std::placeholders::_1, std::placeholders::_2));
+    run("conflict", puzzle, std::bind(
+        &PackedSlidingPuzzleMap::linear_conflict, &map,
+        std::placeholders::_1, std::placeholders::_2));
+    run("pdb 5-5-5", puzzle, pdb_heuristic);
+    run_ida("ida* pdb", puzzle, pdb_heuristic);
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "static_grid_map.h"
+#include "astar_search.h"
+
+// Compare StaticGridMap with GridMap on a 512x512 map, with and without
+// diagonal moves. The same queries are searched with each map. Time is
+// measured around the searches only.
+
+static const int kWidth = 512;
+static const int kHeight = 512;
+static const int kQueries = 32;
+
+class Result {
+public:
+  double time_ms_ = 0;
+  long expansions_ = 0;
+  double cost_ = 0;
+};
+
+template <typename MapType, typename Heuristic>
+Result run(const fudge::VertexMatrix<double, typename MapType::Layout> &matrix,
+           bool enable_diagonal,
+           const std::vector<std::pair<fudge::Coord, fudge::Coord>> &queries,
+           Heuristic heuristic) {
+  Result r;
+  for (const auto &q : queries) {
+    MapType map(matrix, enable_diagonal);
+
+    auto begin = std::chrono::steady_clock::now();
+    fudge::astar_search(map, q.first, q.second, heuristic);
+    auto end = std::chrono::steady_clock::now();
+
+    r.time_ms_ += std::chrono::duration<double, std::milli>(end - begin)
+        .count();
+    r.expansions_ += map.stats_.nodes_closed;
+    r.cost_ += map.node(q.second)->g_;
+  }
+  return r;
+}
+
+// Adapt the constructor of StaticGridMap to the one of GridMap.
+template <bool kDiagonal>
+class Static : public fudge::StaticGridMap<double, kWidth, kHeight, kDiagonal> {
+public:
+  Static(const fudge::VertexMatrix<double, typename Static::Layout> &matrix,
+         bool)
+    : fudge::StaticGridMap<double, kWidth, kHeight, kDiagonal>(matrix) {};
+};
+
+class Runtime : public fudge::GridMap<double> {
+public:
+  using Layout = fudge::RowMajorLayout;
+  using fudge::GridMap<double>::GridMap;
+};
+
+void print(const char *name, const Result &r) {
+  printf("%-16s %10.1f %12ld %14.2f\n", name, r.time_ms_, r.expansions_,
+         r.cost_);
+}
+
+int main (int argc, char *argv[]) {
+  // Weights from 1 to 4 with 20% of obstacles.
+  std::mt19937 rng(512);
+  std::uniform_int_distribution<int> weight(-1, 3);
+  std::vector<double> matrix(kWidth * kHeight);
+  for (double &v : matrix) {
+    int w = weight(rng);
+    v = w < 0 ? -1 : w + 1;
+  }
+
+  std::uniform_int_distribution<int> coord(0, kWidth - 1);
+  std::vector<std::pair<fudge::Coord, fudge::Coord>> queries;
+  while (static_cast<int>(queries.size()) < kQueries) {
+    fudge::Coord s(coord(rng), coord(rng));
+    fudge::Coord g(coord(rng), coord(rng));
+    if (matrix[s.second * kWidth + s.first] > 0
+        && matrix[g.second * kWidth + g.first] > 0)
+      queries.push_back(std::make_pair(s, g));
+  }
+
+  const fudge::VertexMatrix<double> runtime(kWidth, kHeight, matrix);
+  const fudge::VertexMatrix<double, Static<true>::Layout> fixed(
+      kWidth, kHeight, matrix);
+
+  printf("%d queries on %dx%d\n", kQueries, kWidth, kHeight);
+  printf("%-16s %10s %12s %14s\n", "map", "time(ms)", "expansions",
+         "total cost");
+  print("runtime 8", run<Runtime>(runtime, true, queries,
+      fudge::GridMap<double>::diagonal_distance));
+  print("static 8", run<Static<true>>(fixed, true, queries,
+      fudge::GridMap<double>::diagonal_distance));
+  print("runtime 4", run<Runtime>(runtime, false, queries,
+      fudge::GridMap<double>::manhattan_distance));
+  print("static 4", run<Static<false>>(fixed, false, queries,
+      fudge::GridMap<double>::manhattan_distance));
+
+  return 0;
+}
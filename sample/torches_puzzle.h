@@ -1,7 +1,10 @@
 #ifndef TORCHS_PUZZLE_H_
 #define TORCHS_PUZZLE_H_
 
+#include <algorithm>
 #include <bitset>
+#include <cassert>
+#include <cstdint>
 #include "position_map.h"
 
 class Torch {
@@ -19,14 +22,15 @@ public:
   }
 };
 
-class TorchesPosition : public fudge::Position<Torch, int, char> {
+class TorchesPosition
+  : public fudge::StaticPosition<TorchesPosition, Torch, int, char> {
 public:
-  TorchesPosition(const std::vector<Torch> &torches): Position(torches) {}
+  TorchesPosition(const std::vector<Torch> &torches)
+    : StaticPosition(torches) {}
   TorchesPosition() {}
-  virtual ~TorchesPosition() = default;
 
 public:
-  virtual char hash() const override {
+  char hash() const {
     char code = 0;
     for (auto &torch : pos_) {
       (code <<= 1) |= torch.on_ ? 1 : 0;
@@ -34,7 +38,7 @@ public:
     return code;
   }
 
-  virtual const std::string to_string() const override {
+  const std::string to_string() const {
     std::ostringstream ss;
     ss << std::bitset<7>(hash()) << '-' << static_cast<int>(hash());
     return ss.str();
@@ -42,7 +46,8 @@ public:
 };
 
 class TorchesPuzzle 
-  : public fudge::PositionMap<Torch, TorchesPosition, int, char> {
+  : public fudge::PositionMap<Torch, TorchesPosition, int, char,
+        fudge::FlatHashMap<char, TorchesPosition>> {
 public:
   TorchesPuzzle() = default;
   virtual ~TorchesPuzzle() = default;
@@ -75,4 +80,126 @@ public:
   }
 };
 
+// The puzzle as a domain of IdaStarSearch. A move swaps a torch and those it
+// controls, so it's undone by making it again.
+class TorchesDomain {
+public:
+  using State = TorchesPosition;
+  using Move = int;
+  using Cost = int;
+
+public:
+  void moves(const State &s, std::vector<Move> &ms) const {
+    for (std::size_t i = 0; i < s.pos_.size(); ++i)
+      ms.push_back(i);
+  }
+
+  int apply(State &s, Move m) const {
+    for (auto index : s.pos_[m].controlled_)
+      s.pos_[index].swap();
+    s.pos_[m].swap();
+    return 1;
+  }
+
+  void undo(State &s, Move m) const {
+    apply(s, m);
+  }
+
+  bool reverses(Move m, Move last) const {
+    return m == last;
+  }
+
+  bool nodes_equal(const State &s0, const State &s1) const {
+    return s0.hash() == s1.hash();
+  }
+
+  uint64_t hash(const State &s) const {
+    return static_cast<unsigned char>(s.hash());
+  }
+};
+
+// Up to 64 torches as bits of a word, torch i being bit i. A move XORs the
+// word with the toggle mask of the torch, so positions are copied as a word
+// rather than a vector of torches.
+class BitTorchesPosition
+  : public fudge::PositionNode<BitTorchesPosition, int, uint64_t> {
+public:
+  BitTorchesPosition(uint64_t on, int size) : on_(on), size_(size) {};
+  explicit BitTorchesPosition(const TorchesPosition &pos)
+    : size_(pos.pos_.size()) {
+    assert(pos.pos_.size() <= 64);
+    for (std::size_t i = 0; i < pos.pos_.size(); ++i) {
+      if (pos.pos_[i].on_)
+        on_ |= uint64_t(1) << i;
+    }
+  }
+  BitTorchesPosition() {};
+
+public:
+  uint64_t on_ = 0;
+  int8_t size_ = 0;
+
+public:
+  uint64_t hash() const {
+    return on_;
+  }
+
+  // Torch 0 first.
+  const std::string to_string() const {
+    std::string s(size_, '0');
+    for (int i = 0; i < size_; i++) {
+      if ((on_ >> i) & 1)
+        s[i] = '1';
+    }
+    return s;
+  }
+};
+
+class BitTorchesPuzzle
+  : public fudge::PositionMap<char, BitTorchesPosition, int, uint64_t,
+        fudge::FlatHashMap<uint64_t, BitTorchesPosition>> {
+public:
+  explicit BitTorchesPuzzle(const std::vector<Torch> &torches) {
+    assert(torches.size() <= 64);
+    for (const Torch &torch : torches) {
+      uint64_t mask = uint64_t(1) << masks_.size();
+      for (auto index : torch.controlled_)
+        mask ^= uint64_t(1) << index;
+      masks_.push_back(mask);
+      most_toggled_ = std::max(most_toggled_, __builtin_popcountll(mask));
+    }
+  }
+  virtual ~BitTorchesPuzzle() = default;
+
+public:
+  // Toggle mask of each torch.
+  const std::vector<uint64_t> &masks() const {
+    return masks_;
+  }
+
+  // Count of torches in the wrong state, over the most toggled by a move,
+  // which never overestimates.
+  int heuristic(const BitTorchesPosition &n0,
+                const BitTorchesPosition &n1) const {
+    const int d = __builtin_popcountll(n0.on_ ^ n1.on_);
+    return most_toggled_ > 0 ? (d + most_toggled_ - 1) / most_toggled_ : 0;
+  }
+
+public:
+  virtual const std::vector<fudge::Edge<BitTorchesPosition, int>>
+  edges (const BitTorchesPosition &n) override {
+    std::vector<fudge::Edge<BitTorchesPosition, int>> es;
+    es.reserve(masks_.size());
+    for (uint64_t mask : masks_) {
+      BitTorchesPosition pos(n.on_ ^ mask, n.size_);
+      es.push_back(fudge::Edge<BitTorchesPosition, int>(n, pos, 1));
+    }
+    return es;
+  }
+
+private:
+  std::vector<uint64_t> masks_;
+  int most_toggled_ = 0;
+};
+
 #endif /* TORCHS_PUZZLE_H_ */
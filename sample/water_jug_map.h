@@ -3,20 +3,48 @@
 
 #include <sstream>
 #include "position_map.h"
+#include "zobrist.h"
 
-class WaterJugPosition : public fudge::Position<int, int, std::string> {
+using WaterJugKey = fudge::ZobristKey<std::vector<int>>;
+
+// The water in each jug. Jugs are hashed by Zobrist keys, which are updated
+// as water is poured rather than hashed again. The water is kept in the key
+// along with its hash, so positions of the same hash aren't taken as one, and
+// the key is taken without a copy.
+class WaterJugPosition
+  : public fudge::PositionNode<WaterJugPosition, int, WaterJugKey> {
 public:
-  WaterJugPosition(const std::vector<int> &pos) : Position(pos) {};
+  WaterJugPosition(const std::vector<int> &pos) {
+    key_.state_ = pos;
+    for (std::size_t i = 0; i < pos.size(); i++)
+      key_.zobrist_.toggle(i, pos[i]);
+  };
   WaterJugPosition() {};
 
 public:
-  virtual std::string hash() const override {
-    return to_string();
+  WaterJugKey key_;
+
+public:
+  const std::vector<int> &pos() const {
+    return key_.state_;
+  }
+
+  const WaterJugKey &hash() const {
+    return key_;
+  }
+
+  // Pour water from jug i to jug j.
+  void pour(int i, int j, int amount) {
+    std::vector<int> &pos = key_.state_;
+    key_.zobrist_.update(i, pos[i], pos[i] - amount);
+    key_.zobrist_.update(j, pos[j], pos[j] + amount);
+    pos[i] -= amount;
+    pos[j] += amount;
   }
 
-  virtual const std::string to_string() const {
+  const std::string to_string() const {
     std::ostringstream ss;
-    for (auto &e : pos_) {
+    for (auto &e : pos()) {
       ss << e << ',';
     }
     return ss.str();
@@ -24,7 +52,8 @@ public:
 };
 
 class WaterJugMap 
-  : public fudge::PositionMap<std::string, WaterJugPosition, int, std::string> {
+  : public fudge::PositionMap<std::string, WaterJugPosition, int, WaterJugKey,
+        fudge::FlatHashMap<WaterJugKey, WaterJugPosition>> {
 public:
   WaterJugMap(const std::vector<int> &jugs) : jugs_(jugs) {}
   virtual ~WaterJugMap() = default;
@@ -42,20 +71,18 @@ public:
   edges (const WaterJugPosition &n) override {
     std::vector<fudge::Edge<WaterJugPosition, int>> edges;
 
-    for (auto i = n.pos_.begin(); i != n.pos_.end(); ++i) {
+    for (auto i = n.pos().begin(); i != n.pos().end(); ++i) {
       if (*i > 0) {
-        int pos = i - n.pos_.begin();
+        int pos = i - n.pos().begin();
 
-        for (auto j = n.pos_.begin(); j != n.pos_.end(); ++j) {
-          int pos1 = j - n.pos_.begin();
+        for (auto j = n.pos().begin(); j != n.pos().end(); ++j) {
+          int pos1 = j - n.pos().begin();
           if (pos1 != pos) {
             WaterJugPosition n1 = n;
 
             int d = jugs_[pos1] - *j;
             if (d > 0) { // Not completely filled.
-              int dd = std::min(d, *i);
-              n1.pos_[pos1] += dd;
-              n1.pos_[pos] -= dd;
+              n1.pour(pos, pos1, std::min(d, *i));
               fudge::Edge<WaterJugPosition, int> edge (n, n1, 1);
               edges.push_back(edge);
             }
@@ -0,0 +1,151 @@
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "astar_search.h"
+#include "grid_map.h"
+#include "all_pairs_table.h"
+#include "multi_agent_map.h"
+
+// Test if distances and path walks match A* search.
+TEST(AllPairsTable, distance_10x10_wall) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+  fudge::VertexMatrix<double> vertex_matrix(10, 10, matrix);
+
+  fudge::AllPairsTable<double> table;
+  table.build(vertex_matrix, true, 3);
+
+  for (int i = 0; i < 100; i += 7) {
+    for (int j = 0; j < 100; j += 3) {
+      fudge::Coord start(i % 10, i / 10);
+      fudge::Coord goal(j % 10, j / 10);
+      if (!vertex_matrix.is_passable(start)
+          || !vertex_matrix.is_passable(goal) || start == goal)
+        continue;
+
+      fudge::GridMap<double> map(10, 10, matrix);
+      const std::vector<fudge::Coord> path = fudge::astar_search(
+          map, start, goal, fudge::GridMap<double>::diagonal_distance);
+      double g = map.node(goal)->g_;
+
+      ASSERT_NEAR(g, table.distance(start, goal), table.resolution());
+      ASSERT_LE(table.distance(start, goal), g);
+
+      const std::vector<fudge::Coord> walk = table.path(start, goal);
+      ASSERT_EQ(path.size(), walk.size());
+      ASSERT_EQ(goal, walk.front());
+    }
+  }
+  ASSERT_EQ(-1, table.distance(fudge::Coord(0, 0), fudge::Coord(5, 0)));
+}
+
+// Test the table as the heuristic of A*. Only nodes on the path are closed.
+TEST(AllPairsTable, heuristic_100x100) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_100x100.txt");
+  fudge::VertexMatrix<int> vertex_matrix(100, 100, matrix);
+
+  // Only a corner of the map to keep the test fast.
+  std::vector<int> corner;
+  for (int y = 0; y < 20; y++)
+    for (int x = 0; x < 20; x++)
+      corner.push_back(matrix[y * 100 + x]);
+
+  fudge::AllPairsTable<int> table;
+  table.build(fudge::VertexMatrix<int>(20, 20, corner), false);
+  ASSERT_EQ(1, table.resolution());
+
+  fudge::GridMap<int> map0(20, 20, corner, false);
+  const std::vector<fudge::Coord> path0 = fudge::astar_search(
+      map0, fudge::Coord(0, 0), fudge::Coord(19, 19),
+      fudge::GridMap<int>::manhattan_distance);
+
+  fudge::GridMap<int> map1(20, 20, corner, false);
+  const std::vector<fudge::Coord> path1 = fudge::astar_search(
+      map1, fudge::Coord(0, 0), fudge::Coord(19, 19),
+      fudge::AllPairsHeuristic<int>(table));
+
+  ASSERT_EQ(map0.node(fudge::Coord(19, 19))->g_,
+            map1.node(fudge::Coord(19, 19))->g_);
+  ASSERT_EQ(path0.size(), path1.size());
+  ASSERT_LT(map1.stats_.nodes_closed, map0.stats_.nodes_closed);
+}
+
+TEST(AllPairsTable, save_load) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+
+  fudge::AllPairsTable<double> table;
+  table.build(fudge::VertexMatrix<double>(10, 10, matrix));
+  ASSERT_TRUE(table.save("all_pairs_table.bin"));
+
+  fudge::AllPairsTable<double> loaded;
+  ASSERT_TRUE(loaded.load("all_pairs_table.bin"));
+  std::remove("all_pairs_table.bin");
+
+  ASSERT_EQ(table.bytes(), loaded.bytes());
+  for (int i = 0; i < 100; i++)
+    for (int j = 0; j < 100; j++)
+      ASSERT_EQ(table.distance(fudge::Coord(i % 10, i / 10),
+                               fudge::Coord(j % 10, j / 10)),
+                loaded.distance(fudge::Coord(i % 10, i / 10),
+                                fudge::Coord(j % 10, j / 10)));
+
+  ASSERT_FALSE(loaded.load("../data/matrix_10x10_wall.txt"));
+}
+
+// Test if a walk which doesn't reach the goal gives no path. The distances
+// of a saved table are zeroed, so the walk goes back and forth.
+TEST(AllPairsTable, path_not_found) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_plain.txt");
+  fudge::AllPairsTable<double> table;
+  table.build(fudge::VertexMatrix<double>(10, 10, matrix));
+  ASSERT_TRUE(table.save("all_pairs_table.bin"));
+
+  // Distances are stored last.
+  std::ostringstream ss;
+  ss << std::ifstream("all_pairs_table.bin", std::ios::binary).rdbuf();
+  std::string data = ss.str();
+  std::fill(data.end() - table.bytes(), data.end(), '\0');
+  std::ofstream("all_pairs_table.bin", std::ios::binary) << data;
+
+  fudge::AllPairsTable<double> loaded;
+  ASSERT_TRUE(loaded.load("all_pairs_table.bin"));
+  std::remove("all_pairs_table.bin");
+  ASSERT_TRUE(loaded.is_reachable(fudge::Coord(0, 0), fudge::Coord(9, 9)));
+  ASSERT_TRUE(loaded.path(fudge::Coord(0, 0), fudge::Coord(9, 9)).empty());
+  ASSERT_EQ(9u, table.path(fudge::Coord(0, 0), fudge::Coord(9, 9)).size());
+}
+
+// Test the table as the heuristic of multiple agents.
+TEST(AllPairsTable, multi_agent_map) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_10x10_agents.txt");
+  auto table = std::make_shared<fudge::AllPairsTable<int>>();
+  table->build(fudge::VertexMatrix<int>(10, 10, matrix), false);
+
+  MultiAgentMap map(10, 10, matrix);
+  map.use_distance_table(table);
+
+  auto start = MultiAgentNode::create(
+      {},
+      {},
+      {Agent(0, Pos(0, 0), Pos(9, 9), 1),
+       Agent (1, Pos(0, 0), Pos(9, 9), 1)});
+  auto end = MultiAgentNode::create();
+  const std::vector<std::shared_ptr<MultiAgentNode>> path =
+      fudge::astar_search(map, start, end,
+          std::bind(&MultiAgentMap::heuristic_table, &map,
+                    std::placeholders::_1, std::placeholders::_2));
+
+  std::size_t count = 1;
+  for (auto &n : path)
+    if (n->end_of_turn_)
+      ++count;
+  ASSERT_EQ(20, count);
+}
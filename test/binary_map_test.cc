@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "astar_search.h"
+#include "grid_map.h"
+#include "binary_map.h"
+
+// Test if a mapped matrix is searched the same way as the loaded one.
+TEST(BinaryMap, write_map) {
+  int w = 0;
+  int h = 0;
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_100x100.txt", w, h);
+  ASSERT_TRUE(fudge::write_binary_map("binary_map_test.bin", w, h, matrix));
+
+  fudge::MappedMatrix<double> mapped("binary_map_test.bin");
+  ASSERT_TRUE(mapped.is_open());
+  ASSERT_TRUE(mapped.verify());
+  ASSERT_EQ(100, mapped.width());
+  ASSERT_EQ(100, mapped.height());
+  ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(mapped.data()) % 64);
+  ASSERT_TRUE(std::equal(matrix.begin(), matrix.end(), mapped.data()));
+
+  fudge::GridMap<double> map0(w, h, matrix);
+  const std::vector<fudge::Coord> path0 = fudge::astar_search(map0,
+      fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+
+  fudge::GridMap<double> map1(mapped.vertex_matrix());
+  const std::vector<fudge::Coord> path1 = fudge::astar_search(map1,
+      fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+
+  ASSERT_EQ(path0, path1);
+
+  // Weight type should match.
+  fudge::MappedMatrix<int32_t> mapped_int("binary_map_test.bin");
+  ASSERT_FALSE(mapped_int.is_open());
+  std::remove("binary_map_test.bin");
+}
+
+TEST(BinaryMap, corrupted) {
+  std::vector<int32_t> matrix(16, 1);
+  ASSERT_TRUE(fudge::write_binary_map("binary_map_test.bin", 4, 4, matrix));
+  {
+    std::fstream fs("binary_map_test.bin",
+                    std::ios::in | std::ios::out | std::ios::binary);
+    fs.seekp(64 + 5 * sizeof(int32_t));
+    int32_t v = -1;
+    fs.write(reinterpret_cast<const char *>(&v), sizeof(v));
+  }
+  fudge::MappedMatrix<int32_t> mapped("binary_map_test.bin");
+  ASSERT_TRUE(mapped.is_open());
+  ASSERT_FALSE(mapped.verify());
+
+  // Truncated payload.
+  {
+    std::ofstream ofs("binary_map_test.bin", std::ios::binary);
+    ofs.write(reinterpret_cast<const char *>(matrix.data()), 60);
+  }
+  ASSERT_FALSE(fudge::MappedMatrix<int32_t>("binary_map_test.bin").is_open());
+  std::remove("binary_map_test.bin");
+
+  ASSERT_FALSE(fudge::write_binary_map("binary_map_test.bin", 5, 4, matrix));
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "breadth_first_search.h"
+#include "astar_search.h"
+#include "sliding_puzzle_map.h"
+#include "torches_puzzle.h"
+#include "water_jug_map.h"
+#include "util/time_util.h"
+
+// Test if each search finds a shortest path made of valid moves, and if
+// searching from both ends or keeping only the frontier holds fewer nodes.
+TEST(BreadthFirstSearch, search_3x3) {
+  const PackedSlidingPosition start("876543210");
+  const PackedSlidingPosition goal("123456780");
+  PackedSlidingPuzzleMap map(3);
+  fudge::BreadthFirstSearch<PackedSlidingPuzzleMap> search(map);
+
+  PREPARE_TIMER
+  START_TIMER
+  const std::vector<PackedSlidingPosition> path0 = search.search(start, goal);
+  END_TIMER
+  PRINT_TIME_ELAPSED
+  const std::size_t held0 = search.nodes_held();
+
+  START_TIMER
+  const std::vector<PackedSlidingPosition> path1 =
+      search.bidirectional_search(start, goal);
+  END_TIMER
+  PRINT_TIME_ELAPSED
+  const std::size_t held1 = search.nodes_held();
+
+  START_TIMER
+  const std::vector<PackedSlidingPosition> path2 =
+      search.frontier_search(start, goal);
+  END_TIMER
+  PRINT_TIME_ELAPSED
+  const std::size_t held2 = search.nodes_held();
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_LT(held1, held0 / 10);
+  ASSERT_LT(held2, held0 / 2);
+  for (const auto &path : {path0, path1, path2}) {
+    ASSERT_EQ(31, path.size());
+    ASSERT_EQ(goal, path.front());
+    ASSERT_EQ(start, path.back());
+    for (std::size_t i = 1; i < path.size(); i++)
+      ASSERT_EQ(1, map.manhattan_distance(path[i - 1], path[i]));
+  }
+}
+
+TEST(BreadthFirstSearch, search_2x2_not_found) {
+  PackedSlidingPuzzleMap map(2);
+  fudge::BreadthFirstSearch<PackedSlidingPuzzleMap> search(map);
+  const PackedSlidingPosition start("1320");
+  const PackedSlidingPosition goal("1230");
+  ASSERT_TRUE(search.search(start, goal).empty());
+  ASSERT_TRUE(search.bidirectional_search(start, goal).empty());
+  ASSERT_TRUE(search.frontier_search(start, goal).empty());
+  ASSERT_EQ(12, search.nodes_expanded());
+}
+
+// Pouring isn't reversible, so only searches from the start are used.
+TEST(BreadthFirstSearch, search_water_jug) {
+  WaterJugMap map({21, 15, 8, 5});
+  fudge::BreadthFirstSearch<WaterJugMap> search(map);
+  const WaterJugPosition start({21, 0, 0, 0});
+  const WaterJugPosition goal({7, 7, 7, 0});
+
+  const std::vector<WaterJugPosition> path0 = search.search(start, goal);
+  ASSERT_EQ(12, path0.size());
+  ASSERT_EQ(11, map.current_cost(path0.front()));
+
+  const std::vector<WaterJugPosition> path1 =
+      search.frontier_search(start, goal);
+  ASSERT_EQ(12, path1.size());
+  ASSERT_EQ("7,7,7,0,", path1.front().to_string());
+  ASSERT_EQ("21,0,0,0,", path1.back().to_string());
+}
+
+// Test if the frontier search stops on a goal it can't reach, though nodes of
+// older layers come back as pouring isn't reversible.
+TEST(BreadthFirstSearch, search_water_jug_not_found) {
+  WaterJugMap map({21, 15, 8, 5});
+  fudge::BreadthFirstSearch<WaterJugMap> search(map);
+  const WaterJugPosition start({21, 0, 0, 0});
+  const WaterJugPosition goal({7, 7, 7, 1});
+
+  ASSERT_TRUE(search.search(start, goal).empty());
+  const std::size_t expanded = search.nodes_expanded();
+  ASSERT_TRUE(search.frontier_search(start, goal).empty());
+  ASSERT_GE(search.nodes_expanded(), expanded);
+}
+
+TEST(BreadthFirstSearch, search_torches) {
+  TorchesPosition start({
+    {1, 6},
+    {2, 3},
+    {3, 4},
+    {4, 6},
+    {5, 3},
+    {6, 0},
+    {0, 1}});
+  start.pos_[0].on_ = true;
+  start.pos_[1].on_ = true;
+  TorchesPosition end = start;
+  for (auto &t : end.pos_)
+    t.on_ = true;
+
+  TorchesPuzzle map;
+  fudge::BreadthFirstSearch<TorchesPuzzle> search(map);
+  ASSERT_EQ(4, search.search(start, end).size());
+  ASSERT_EQ(4, search.bidirectional_search(start, end).size());
+  ASSERT_EQ(4, search.frontier_search(start, end).size());
+}
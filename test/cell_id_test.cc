@@ -0,0 +1,70 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "cell_id.h"
+#include "grid_map.h"
+#include "sparse_grid_node_array.h"
+#include "astar_search.h"
+#include "load_matrix.h"
+
+// Test if coordinates are packed and unpacked.
+TEST(CellId, convert) {
+  ASSERT_EQ(0x00020001u, fudge::cell_id(fudge::Coord(1, 2)));
+  ASSERT_EQ(fudge::Coord(65534, 65534),
+            fudge::cell_coord(fudge::cell_id(65534, 65534)));
+  ASSERT_EQ(fudge::kNoCell, fudge::cell_id(fudge::Coord(-1, -1)));
+  ASSERT_EQ(fudge::Coord(-1, -1), fudge::cell_coord(fudge::kNoCell));
+
+  // Ids of a row are ordered by x, and rows are ordered by y.
+  ASSERT_LT(fudge::cell_id(9, 0), fudge::cell_id(0, 1));
+  ASSERT_LT(fudge::cell_id(0, 1), fudge::cell_id(1, 1));
+
+  std::vector<fudge::Coord> coords {{0, 0}, {3, 4}, {100, 7}};
+  ASSERT_EQ(coords, fudge::cell_coords(fudge::cell_ids(coords)));
+}
+
+// Test if paths of cell ids are the same as paths of coordinates.
+TEST(CellId, path) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+  fudge::GridMap<double> map0(10, 10, matrix);
+  fudge::GridMap<double> map1(10, 10, matrix);
+
+  const std::vector<fudge::Coord> path = fudge::astar_search(
+      map0, fudge::Coord(0, 0), fudge::Coord(9, 9),
+      fudge::GridMap<double>::diagonal_distance);
+  fudge::astar_search(map1, fudge::Coord(0, 0), fudge::Coord(9, 9),
+                      fudge::GridMap<double>::diagonal_distance);
+
+  ASSERT_FALSE(path.empty());
+  ASSERT_EQ(fudge::cell_ids(path), map1.get_cell_path(fudge::Coord(9, 9)));
+  ASSERT_EQ(map0.to_string(), map1.to_string());
+  ASSERT_EQ(fudge::Coord(9, 9), map1.node(fudge::Coord(9, 9))->c());
+}
+
+// Test the last cell of the largest map, which doesn't take the id of
+// kNoCell, and wide ids of larger maps.
+TEST(CellId, boundary) {
+  const int last = fudge::kMaxCellIdSide - 1;
+  ASSERT_TRUE(fudge::fits_cell_ids(65535, 65535));
+  ASSERT_FALSE(fudge::fits_cell_ids(65536, 1));
+  ASSERT_FALSE(fudge::fits_cell_ids(1, 65536));
+  ASSERT_NE(fudge::kNoCell, fudge::cell_id(last, last));
+  ASSERT_EQ(fudge::Coord(last, last),
+            fudge::cell_coord(fudge::cell_id(last, last)));
+
+  for (int i : {65535, 65536, 1 << 20, 0x7FFFFFFF}) {
+    const fudge::WideCellId id = fudge::wide_cell_id(i, i - 1);
+    ASSERT_NE(fudge::kNoWideCell, id);
+    ASSERT_EQ(fudge::Coord(i, i - 1), fudge::cell_coord(id));
+  }
+  ASSERT_EQ(fudge::kNoWideCell, fudge::wide_cell_id(-1, -1));
+
+  // A sparse node array keeps nodes beyond 65535 apart.
+  fudge::SparseGridNodeArray<int> nodes;
+  ASSERT_EQ(fudge::Coord(70000, 65535),
+            nodes.node(fudge::Coord(70000, 65535))->c());
+  ASSERT_EQ(fudge::Coord(65535, 65535),
+            nodes.node(fudge::Coord(65535, 65535))->c());
+  ASSERT_NE(nodes.node(fudge::Coord(4464, 65535)),
+            nodes.node(fudge::Coord(70000, 65535)));
+}
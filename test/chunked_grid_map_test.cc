@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <vector>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "astar_search.h"
+#include "grid_map.h"
+#include "chunked_grid_map.h"
+
+// Test if a chunked map is searched the same way as the dense one, with less
+// chunks in memory than the map has.
+TEST(ChunkedGridMap, search) {
+  int w = 0;
+  int h = 0;
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_100x100.txt", w, h);
+  ASSERT_TRUE(fudge::write_chunked_map("chunked_map_test.bin", w, h, 16,
+                                       matrix));
+
+  fudge::ChunkedMatrix<double> chunked("chunked_map_test.bin", 4);
+  ASSERT_TRUE(chunked.is_open());
+  ASSERT_EQ(100, chunked.width_);
+  ASSERT_EQ(100, chunked.height_);
+  ASSERT_FALSE(chunked.is_passable(fudge::Coord(100, 0)));
+
+  for (bool diagonal : {true, false}) {
+    fudge::GridMap<double> map0(w, h, matrix, diagonal);
+    const std::vector<fudge::Coord> path0 = fudge::astar_search(map0,
+        fudge::Coord(0, 0), fudge::Coord(99, 99),
+        fudge::GridMap<double>::manhattan_distance);
+
+    fudge::ChunkedGridMap<double> map1(chunked, diagonal, 8);
+    const std::vector<fudge::Coord> path1 = fudge::astar_search(map1,
+        fudge::Coord(0, 0), fudge::Coord(99, 99),
+        fudge::GridMap<double>::manhattan_distance);
+
+    ASSERT_EQ(path0, path1);
+    ASSERT_DOUBLE_EQ(map0.node(fudge::Coord(99, 99))->g_,
+                     map1.node(fudge::Coord(99, 99))->g_);
+  }
+  ASSERT_EQ(4u, chunked.stats_.entries);
+  ASSERT_GT(chunked.stats_.evictions, 0);
+
+  std::remove("chunked_map_test.bin");
+}
+
+// Test if memory is proportional to the area explored.
+TEST(ChunkedGridMap, sparse) {
+  const int w = 2048;
+  const int h = 1024;
+  ASSERT_TRUE(fudge::write_chunked_map<int>("chunked_map_test.bin", w, h, 64,
+      [](int x, int y) { return (x == 1000 && y < 100) ? -1 : 1; }));
+
+  fudge::ChunkedMatrix<int> chunked("chunked_map_test.bin", 16);
+  fudge::ChunkedGridMap<int> map(chunked);
+  const std::vector<fudge::Coord> path = fudge::astar_search(map,
+      fudge::Coord(900, 10), fudge::Coord(1100, 10),
+      fudge::GridMap<int>::diagonal_distance);
+
+  ASSERT_FALSE(path.empty());
+  ASSERT_LE(chunked.stats_.bytes, 16u * 64 * 64 * sizeof(int));
+  const std::size_t dense_bytes =
+      static_cast<std::size_t>(w) * h * sizeof(fudge::GridNode<int>);
+  ASSERT_LT(map.node_bytes(), dense_bytes / 16);
+
+  std::remove("chunked_map_test.bin");
+}
+
+TEST(ChunkedGridMap, invalid) {
+  std::vector<int> matrix(100, 1);
+  ASSERT_FALSE(fudge::write_chunked_map("chunked_map_test.bin", 10, 10, 12,
+                                        matrix));
+  ASSERT_FALSE(fudge::write_chunked_map("chunked_map_test.bin", 10, 9, 16,
+                                        matrix));
+
+  fudge::ChunkedMatrix<int> missing("no_such_file.bin");
+  ASSERT_FALSE(missing.is_open());
+
+  ASSERT_TRUE(fudge::write_chunked_map("chunked_map_test.bin", 10, 10, 16,
+                                       matrix));
+  fudge::ChunkedMatrix<double> wrong_type("chunked_map_test.bin");
+  ASSERT_FALSE(wrong_type.is_open());
+
+  std::remove("chunked_map_test.bin");
+}
@@ -0,0 +1,52 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "grid_map.h"
+#include "astar_search.h"
+#include "load_matrix.h"
+
+// Test if costs are converted to and from fixed-point.
+TEST(CostScale, fixed) {
+  typedef fudge::FixedScale<1000> Scale;
+  ASSERT_EQ(1000, Scale::kStraightEdgeWeight);
+  ASSERT_EQ(1414, Scale::kDiagonalEdgeWeight);
+  ASSERT_EQ(12728, Scale::to_fixed(12.7279));
+  ASSERT_EQ(-1000, Scale::to_fixed(-1.0));
+  ASSERT_DOUBLE_EQ(1.414, Scale::to_double(1414));
+
+  ASSERT_EQ(9000, fudge::FixedGridMap<>::manhattan_distance(
+      fudge::Coord(0, 0), fudge::Coord(4, 5)));
+  ASSERT_EQ(4 * 1414 + 1000, fudge::FixedGridMap<>::diagonal_distance(
+      fudge::Coord(0, 0), fudge::Coord(4, 5)));
+}
+
+// Test if a fixed-point map finds the same path as a floating point one, with
+// the cost of the path in fixed-point.
+TEST(CostScale, search_10x10_wall) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+  std::vector<int32_t> fixed_matrix = fudge::load_matrix<int32_t>(
+      "../data/matrix_10x10_wall.txt");
+
+  fudge::GridMap<double> map0(10, 10, matrix);
+  const std::vector<fudge::Coord> path0 = fudge::astar_search(
+      map0, fudge::Coord(0, 0), fudge::Coord(9, 9),
+      fudge::GridMap<double>::diagonal_distance);
+
+  fudge::FixedGridMap<> map1(10, 10, fixed_matrix);
+  const std::vector<fudge::Coord> path1 = fudge::astar_search(
+      map1, fudge::Coord(0, 0), fudge::Coord(9, 9),
+      fudge::FixedGridMap<>::diagonal_distance);
+
+  ASSERT_FALSE(path1.empty());
+  ASSERT_EQ(path0, path1);
+
+  int32_t cost = 0;
+  fudge::Coord p(0, 0);
+  for (auto i = path1.rbegin(); i != path1.rend(); ++i) {
+    cost += (i->first != p.first && i->second != p.second) ? 1414 : 1000;
+    p = *i;
+  }
+  ASSERT_EQ(cost, map1.current_cost(fudge::Coord(9, 9)));
+  ASSERT_NEAR(map0.current_cost(fudge::Coord(9, 9)),
+              fudge::FixedScale<>::to_double(cost), 0.001 * path1.size());
+}
@@ -0,0 +1,40 @@
+#include <string>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include "flat_hash_map.h"
+
+// Test if values are found after the table grows.
+TEST(FlatHashMap, insert_int) {
+  fudge::FlatHashMap<int, int> map(4);
+  for (int i = 0; i < 10000; i++)
+    map[i * 16] = i;
+
+  ASSERT_EQ(10000u, map.size());
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_EQ(1u, map.count(i * 16));
+    ASSERT_EQ(i, map.at(i * 16));
+    ASSERT_EQ(0u, map.count(i * 16 + 1));
+  }
+  ASSERT_THROW(map.at(-1), std::out_of_range);
+
+  map[32] = -2;
+  ASSERT_EQ(10000u, map.size());
+  ASSERT_EQ(-2, map.at(32));
+  ASSERT_EQ(32, map.entries()[2].first);
+
+  map.clear();
+  ASSERT_EQ(0u, map.size());
+  ASSERT_EQ(0u, map.count(32));
+}
+
+TEST(FlatHashMap, insert_string) {
+  fudge::FlatHashMap<std::string, std::string> map;
+  map["876543210"] = "a";
+  map["123456780"] = "b";
+  map["876543210"] += "c";
+
+  ASSERT_EQ(2u, map.size());
+  ASSERT_EQ("ac", map.at("876543210"));
+  ASSERT_EQ("b", map.at("123456780"));
+  ASSERT_EQ(0u, map.count("012345678"));
+}
@@ -0,0 +1,77 @@
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "grid_map.h"
+#include "astar_search.h"
+#include "load_matrix.h"
+
+// Test if a layout gives each cell its own index within the storage.
+template <typename Layout>
+void check_indices(int w, int h) {
+  Layout layout(w, h);
+  std::set<std::size_t> indices;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      std::size_t i = layout.index(fudge::Coord(x, y));
+      ASSERT_LT(i, layout.size());
+      indices.insert(i);
+    }
+  }
+  ASSERT_EQ(static_cast<std::size_t>(w * h), indices.size());
+}
+
+TEST(GridLayout, indices) {
+  check_indices<fudge::RowMajorLayout>(7, 5);
+  check_indices<fudge::BlockedLayout<4>>(7, 5);
+  check_indices<fudge::BlockedLayout<8>>(17, 9);
+  check_indices<fudge::MortonLayout>(7, 5);
+  check_indices<fudge::MortonLayout>(16, 16);
+
+  ASSERT_EQ(64u, fudge::BlockedLayout<8>(8, 8).size());
+  ASSERT_EQ(256u, fudge::MortonLayout(16, 16).size());
+  ASSERT_EQ(2u, fudge::MortonLayout(1, 1).index(fudge::Coord(0, 1)));
+}
+
+// Test if a matrix in another layout gives the same weights.
+TEST(GridLayout, vertex_matrix) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+  fudge::VertexMatrix<double> row_major(10, 10, matrix);
+  fudge::VertexMatrix<double, fudge::BlockedLayout<4>> blocked(10, 10, matrix);
+  fudge::VertexMatrix<double, fudge::MortonLayout> morton(10, 10, matrix);
+
+  ASSERT_EQ(matrix.data(), row_major.data());
+  ASSERT_NE(matrix.data(), morton.data());
+  for (int y = 0; y < 10; y++) {
+    for (int x = 0; x < 10; x++) {
+      fudge::Coord c(x, y);
+      ASSERT_EQ(row_major.weight(c), blocked.weight(c));
+      ASSERT_EQ(row_major.weight(c), morton.weight(c));
+    }
+  }
+  ASSERT_EQ(row_major.to_string(), morton.to_string());
+}
+
+// Test if searches give the same path with any layout.
+TEST(GridLayout, search) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_100x100.txt");
+  fudge::GridMap<double> row_major(100, 100, matrix);
+  fudge::GridMap<double, fudge::BlockedLayout<8>> blocked(100, 100, matrix);
+  fudge::GridMap<double, fudge::MortonLayout> morton(100, 100, matrix);
+
+  const std::vector<fudge::Coord> p0 = fudge::astar_search(
+      row_major, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+  const std::vector<fudge::Coord> p1 = fudge::astar_search(
+      blocked, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+  const std::vector<fudge::Coord> p2 = fudge::astar_search(
+      morton, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+
+  ASSERT_FALSE(p0.empty());
+  ASSERT_EQ(p0, p1);
+  ASSERT_EQ(p0, p2);
+  ASSERT_EQ(row_major.stats_.nodes_closed, morton.stats_.nodes_closed);
+}
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "grid_map.h"
+#include "jump_point_map.h"
 #include "astar_search.h"
 #include "load_matrix.h"
+#include "versioned_matrix.h"
 #include "util/time_util.h"
 
 // Helper to print and return result.
@@ -165,3 +167,42 @@ TEST(GridMap, search_10x10_2_targets) {
   ASSERT_EQ(46, map0.stats_.nodes_opened);
   ASSERT_EQ(23, map1.stats_.nodes_opened);
 }
+
+// Test if a map made from a vector sees later edits of the vector, and one
+// made from a snapshot sees the weights of the snapshot.
+TEST(GridMap, is_passable) {
+  std::vector<double> matrix(9, 1.0);
+  fudge::GridMap<double> map(3, 3, matrix);
+  ASSERT_TRUE(map.is_passable(fudge::Coord(1, 1)));
+  ASSERT_FALSE(map.is_passable(fudge::Coord(3, 1)));
+  matrix[4] = -1;
+  ASSERT_FALSE(map.is_passable(fudge::Coord(1, 1)));
+
+  fudge::VersionedMatrix<double> versioned(3, 3, matrix);
+  fudge::GridMap<double> snapshot_map(versioned.snapshot());
+  versioned.apply_updates({{fudge::Coord(1, 1), 1.0}});
+  ASSERT_FALSE(snapshot_map.is_passable(fudge::Coord(1, 1)));
+  ASSERT_TRUE(fudge::GridMap<double>(versioned.snapshot()).is_passable(
+      fudge::Coord(1, 1)));
+}
+
+// Test if a map looking obstacles up in a bitmap sees weights edited in place
+// once they are updated, and a jump point map takes heavy cells as obstacles.
+TEST(GridMap, passability_bitmap) {
+  std::vector<double> matrix(9, 1.0);
+  fudge::GridMap<double> map(3, 3, matrix);
+  map.use_passability_bitmap();
+  matrix[4] = -1;
+  ASSERT_TRUE(map.is_passable(fudge::Coord(1, 1)));
+  map.update(fudge::CellRegion(1, 1, 1, 1));
+  ASSERT_FALSE(map.is_passable(fudge::Coord(1, 1)));
+  ASSERT_FALSE(map.is_passable(fudge::Coord(-1, 1)));
+
+  matrix[4] = 2.0;
+  fudge::JumpPointMap<double> jump_map(3, 3, matrix);
+  const fudge::GridMap<double> &jump_grid = jump_map;
+  ASSERT_FALSE(jump_grid.is_passable(fudge::Coord(1, 1)));
+  matrix[4] = 1.0;
+  jump_map.update(fudge::CellRegion(0, 0, 2, 2));
+  ASSERT_TRUE(jump_grid.is_passable(fudge::Coord(1, 1)));
+}
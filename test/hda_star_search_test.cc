@@ -0,0 +1,75 @@
+#include <functional>
+#include <gtest/gtest.h>
+#include "hda_star_search.h"
+#include "astar_search.h"
+#include "sliding_puzzle_map.h"
+#include "water_jug_map.h"
+#include "util/time_util.h"
+
+typedef std::function<int(const PackedSlidingPosition &,
+                          const PackedSlidingPosition &)> SlidingHeuristic;
+typedef fudge::HdaStarSearch<PackedSlidingPuzzleMap, SlidingHeuristic>
+    SlidingSearch;
+
+// Test if paths found by any count of threads are as short as A*, and are
+// made of valid moves.
+TEST(HdaStarSearch, search_3x3) {
+  const PackedSlidingPosition start("876543210");
+  const PackedSlidingPosition goal("123456780");
+  PackedSlidingPuzzleMap map(3);
+  const SlidingHeuristic heuristic = std::bind(
+      &PackedSlidingPuzzleMap::manhattan_distance, &map,
+      std::placeholders::_1, std::placeholders::_2);
+
+  for (int threads : {1, 2, 4}) {
+    SlidingSearch search(map, heuristic, threads);
+    const std::vector<PackedSlidingPosition> path = search.search(start, goal);
+    ASSERT_EQ(31, path.size());
+    ASSERT_EQ(goal, path.front());
+    ASSERT_EQ(start, path.back());
+    for (std::size_t i = 1; i < path.size(); i++)
+      ASSERT_EQ(1, map.manhattan_distance(path[i - 1], path[i]));
+  }
+}
+
+TEST(HdaStarSearch, search_4x4) {
+  PREPARE_TIMER
+  START_TIMER
+  PackedSlidingPuzzleMap map(4);
+  SlidingSearch search(map, std::bind(
+      &PackedSlidingPuzzleMap::linear_conflict, &map,
+      std::placeholders::_1, std::placeholders::_2), 4);
+  const std::vector<PackedSlidingPosition> path = search.search(
+      PackedSlidingPosition("6403217b5de8a9cf"),
+      PackedSlidingPosition("123456789abcdef0"));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  ASSERT_EQ(35, path.size());
+  ASSERT_GT(search.map(0).stats_.nodes_closed, 0);
+  ASSERT_GT(search.map(3).stats_.nodes_closed, 0);
+}
+
+// Test if the search ends once every position has been explored.
+TEST(HdaStarSearch, search_2x2_not_found) {
+  PackedSlidingPuzzleMap map(2);
+  SlidingSearch search(map, std::bind(
+      &PackedSlidingPuzzleMap::manhattan_distance, &map,
+      std::placeholders::_1, std::placeholders::_2), 3);
+  const std::vector<PackedSlidingPosition> path = search.search(
+      PackedSlidingPosition("1320"), PackedSlidingPosition("1230"));
+  ASSERT_TRUE(path.empty());
+  ASSERT_EQ(12, search.nodes_expanded());
+}
+
+TEST(HdaStarSearch, search_water_jug) {
+  WaterJugMap map({21, 15, 8, 5});
+  auto heuristic = std::bind(&WaterJugMap::heuristic, map,
+                             std::placeholders::_1, std::placeholders::_2);
+  fudge::HdaStarSearch<WaterJugMap, decltype(heuristic)> search(
+      map, heuristic, 4);
+  const std::vector<WaterJugPosition> path = search.search(
+      WaterJugPosition({21, 0, 0, 0}), WaterJugPosition({7, 7, 7, 0}));
+  ASSERT_EQ(12, path.size());
+  ASSERT_EQ("7,7,7,0,", path.front().to_string());
+}
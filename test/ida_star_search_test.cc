@@ -0,0 +1,118 @@
+#include <functional>
+#include <gtest/gtest.h>
+#include "ida_star_search.h"
+#include "astar_search.h"
+#include "sliding_puzzle_map.h"
+#include "torches_puzzle.h"
+#include "util/time_util.h"
+
+typedef std::function<int(const PackedSlidingPosition &,
+                          const PackedSlidingPosition &)> SlidingHeuristic;
+typedef fudge::IdaStarSearch<PackedSlidingPuzzleDomain, SlidingHeuristic>
+    SlidingSearch;
+
+// Test if IDA* finds a path as short as A*, and if the transposition table
+// cuts expansions without making the path longer.
+TEST(IdaStarSearch, search_3x3) {
+  const PackedSlidingPosition start("876543210");
+  const PackedSlidingPosition goal("123456780");
+  PackedSlidingPuzzleMap map(3);
+  const SlidingHeuristic heuristic = std::bind(
+      &PackedSlidingPuzzleMap::manhattan_distance, &map,
+      std::placeholders::_1, std::placeholders::_2);
+  const std::vector<PackedSlidingPosition> path0 =
+      fudge::astar_search(map, start, goal, heuristic);
+
+  PackedSlidingPuzzleDomain domain(3);
+  SlidingSearch search1(domain, heuristic);
+  ASSERT_TRUE(search1.search(start, goal));
+  const std::vector<PackedSlidingPosition> path1 = search1.path();
+
+  SlidingSearch search2(domain, heuristic, 1 << 16);
+  ASSERT_TRUE(search2.search(start, goal));
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_EQ(path0.size(), path1.size());
+  ASSERT_EQ(30, search1.moves().size());
+  ASSERT_EQ(30, search1.cost());
+  ASSERT_EQ(30, search2.cost());
+  ASSERT_LT(search2.nodes_expanded(), search1.nodes_expanded());
+  ASSERT_EQ(goal, path1.front());
+  ASSERT_EQ(start, path1.back());
+  for (std::size_t i = 1; i < path1.size(); i++)
+    ASSERT_EQ(1, map.manhattan_distance(path1[i - 1], path1[i]));
+}
+
+TEST(IdaStarSearch, search_4x4) {
+  PREPARE_TIMER
+  START_TIMER
+  PackedSlidingPuzzleMap map(4);
+  PackedSlidingPuzzleDomain domain(4);
+  SlidingSearch search(domain, std::bind(
+      &PackedSlidingPuzzleMap::linear_conflict, &map,
+      std::placeholders::_1, std::placeholders::_2));
+  ASSERT_TRUE(search.search(PackedSlidingPosition("6403217b5de8a9cf"),
+                            PackedSlidingPosition("123456789abcdef0")));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  ASSERT_EQ(34, search.cost());
+}
+
+// Test if the search gives up on a goal not reachable.
+TEST(IdaStarSearch, search_2x2_not_found) {
+  PackedSlidingPuzzleMap map(2);
+  PackedSlidingPuzzleDomain domain(2);
+  SlidingSearch search(domain, std::bind(
+      &PackedSlidingPuzzleMap::manhattan_distance, &map,
+      std::placeholders::_1, std::placeholders::_2));
+  ASSERT_FALSE(search.search(PackedSlidingPosition("1320"),
+                             PackedSlidingPosition("1230"), 20));
+  ASSERT_TRUE(search.moves().empty());
+}
+
+TEST(IdaStarSearch, search_torches) {
+  TorchesPosition start({
+    {1, 6},
+    {2, 3},
+    {3, 4},
+    {4, 6},
+    {5, 3},
+    {6, 0},
+    {0, 1}});
+  start.pos_[0].on_ = true;
+  start.pos_[1].on_ = true;
+  TorchesPosition end = start;
+  for (auto &t : end.pos_)
+    t.on_ = true;
+
+  TorchesPuzzle map;
+  TorchesDomain domain;
+  auto heuristic = std::bind(&TorchesPuzzle::heuristic, &map,
+                             std::placeholders::_1, std::placeholders::_2);
+  fudge::IdaStarSearch<TorchesDomain, decltype(heuristic)> search(
+      domain, heuristic, 128);
+  ASSERT_TRUE(search.search(start, end));
+  ASSERT_EQ(3, search.cost());
+  ASSERT_EQ(end.hash(), search.path().front().hash());
+}
+
+// Test if the search on a map gives the same path length as A*.
+TEST(IdaStarSearch, search_map) {
+  SlidingPuzzleMap map0(3);
+  const std::vector<SlidingPosition> path0 = fudge::astar_search(map0,
+      SlidingPosition("123405786"), SlidingPosition("123456780"),
+      std::bind(&SlidingPuzzleMap::manhattan_distance, &map0,
+          std::placeholders::_1, std::placeholders::_2));
+
+  SlidingPuzzleMap map1(3);
+  const std::vector<SlidingPosition> path1 = fudge::ida_star_search(map1,
+      SlidingPosition("123405786"), SlidingPosition("123456780"),
+      std::bind(&SlidingPuzzleMap::manhattan_distance, &map1,
+          std::placeholders::_1, std::placeholders::_2));
+
+  ASSERT_EQ(3, path0.size());
+  ASSERT_EQ(path0.size(), path1.size());
+  ASSERT_EQ("123456780", path1.front().to_string());
+  ASSERT_EQ(0, map1.map_.size()); // Nothing stored in the map.
+}
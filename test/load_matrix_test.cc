@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+
+// Helper to write a temporary file.
+static void write_file(const std::string &filename,
+                       const std::string &content) {
+  std::ofstream ofs(filename);
+  ofs << content;
+}
+
+TEST(LoadMatrix, detect_size) {
+  int w = 0;
+  int h = 0;
+  std::vector<int> m0 = fudge::load_matrix<int>(
+      "../data/matrix_100x100.txt", w, h);
+  ASSERT_EQ(100, w);
+  ASSERT_EQ(100, h);
+  ASSERT_EQ(10000, m0.size());
+
+  std::vector<double> m1 = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt", w, h);
+  ASSERT_EQ(10, w);
+  ASSERT_EQ(10, h);
+  ASSERT_EQ(-1, m1[5]);
+  ASSERT_EQ(1, m1[99]);
+}
+
+TEST(LoadMatrix, parse_numbers) {
+  write_file("load_matrix_test.txt",
+             " 1.5, -2,3e2 \r\n\n0.0001,+7, 1.4143,\n");
+  int w = 0;
+  int h = 0;
+  std::vector<double> m = fudge::load_matrix<double>(
+      "load_matrix_test.txt", w, h);
+  std::remove("load_matrix_test.txt");
+
+  ASSERT_EQ(3, w);
+  ASSERT_EQ(2, h);
+  std::vector<double> expected {1.5, -2, 300, 0.0001, 7, 1.4143};
+  ASSERT_EQ(expected, m);
+}
+
+TEST(LoadMatrix, malformed) {
+  int w = 0;
+  int h = 0;
+
+  write_file("load_matrix_test.txt", "1, 2, 3,\n4, x, 6,\n");
+  ASSERT_EQ(0, fudge::load_matrix<int>("load_matrix_test.txt", w, h).size());
+  ASSERT_EQ(0, w);
+  ASSERT_EQ(0, h);
+
+  write_file("load_matrix_test.txt", "1, 2, 3,\n4, 5,\n");
+  ASSERT_EQ(0, fudge::load_matrix<int>("load_matrix_test.txt", w, h).size());
+
+  write_file("load_matrix_test.txt", "1, 2.5, 3,\n");
+  ASSERT_EQ(0, fudge::load_matrix<int>("load_matrix_test.txt", w, h).size());
+
+  write_file("load_matrix_test.txt", "1,, 3,\n");
+  ASSERT_EQ(0, fudge::load_matrix<int>("load_matrix_test.txt", w, h).size());
+  std::remove("load_matrix_test.txt");
+
+  ASSERT_EQ(0, fudge::load_matrix<int>("missing.txt", w, h).size());
+}
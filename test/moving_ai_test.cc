@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "astar_search.h"
+#include "grid_map.h"
+#include "moving_ai.h"
+
+// Test if a map is converted to weights.
+TEST(MovingAI, load_map) {
+  int w = 0;
+  int h = 0;
+  std::vector<int> matrix = fudge::load_moving_ai_map<int>(
+      "../data/moving_ai_16x16.map", w, h, 5);
+  ASSERT_EQ(16, w);
+  ASSERT_EQ(16, h);
+  ASSERT_EQ(256u, matrix.size());
+  ASSERT_EQ(1, matrix[0]);
+  ASSERT_EQ(5, matrix[1 * 16 + 12]);  // Swamp
+  ASSERT_EQ(-1, matrix[2 * 16 + 5]);  // Obstacle
+}
+
+// Test if scenarios are parsed and solved with the expected cost, keeping
+// corners whole as the scenarios do.
+TEST(MovingAI, load_scenarios) {
+  const std::vector<fudge::MovingAIScenario> scenarios =
+      fudge::load_moving_ai_scenarios("../data/moving_ai_16x16.map.scen");
+  ASSERT_EQ(40u, scenarios.size());
+  ASSERT_EQ(0, scenarios[0].bucket_);
+  ASSERT_EQ("moving_ai_16x16.map", scenarios[0].map_);
+  ASSERT_EQ(16, scenarios[0].map_width_);
+  ASSERT_EQ(fudge::Coord(0, 10), scenarios[0].start_);
+  ASSERT_EQ(fudge::Coord(2, 11), scenarios[0].goal_);
+  ASSERT_NEAR(2.41421356, scenarios[0].optimal_length_, 1e-8);
+
+  int w = 0;
+  int h = 0;
+  std::vector<double> matrix = fudge::load_moving_ai_map<double>(
+      "../data/moving_ai_16x16.map", w, h);
+  for (const fudge::MovingAIScenario &s : scenarios) {
+    fudge::GridMap<double> map(w, h, matrix);
+    map.enable_corner_cutting(false);
+    const std::vector<fudge::Coord> path = fudge::astar_search(map,
+        s.start_, s.goal_, fudge::GridMap<double>::diagonal_distance);
+    ASSERT_FALSE(path.empty());
+    ASSERT_NEAR(s.optimal_length_, map.node(s.goal_)->g_,
+                s.optimal_length_ * 1e-4 + 1e-3);
+
+    // Cutting corners, the path is not longer.
+    fudge::GridMap<double> cutting_map(w, h, matrix);
+    fudge::astar_search(cutting_map, s.start_, s.goal_,
+                        fudge::GridMap<double>::diagonal_distance);
+    ASSERT_LE(cutting_map.node(s.goal_)->g_, map.node(s.goal_)->g_);
+  }
+}
+
+// Test if malformed files are rejected.
+TEST(MovingAI, malformed) {
+  int w = 0;
+  int h = 0;
+  ASSERT_TRUE(fudge::load_moving_ai_map<int>("no_such.map", w, h).empty());
+
+  {
+    std::ofstream ofs("moving_ai_test.map");
+    ofs << "type octile\nheight 2\nwidth 3\nmap\n...\n.X.\n";
+  }
+  ASSERT_TRUE(fudge::load_moving_ai_map<int>("moving_ai_test.map", w, h)
+              .empty());
+  ASSERT_EQ(0, w);
+
+  {
+    std::ofstream ofs("moving_ai_test.map");
+    ofs << "type octile\nheight 2\nwidth 3\nmap\n...\n";
+  }
+  ASSERT_TRUE(fudge::load_moving_ai_map<int>("moving_ai_test.map", w, h)
+              .empty());
+
+  {
+    std::ofstream ofs("moving_ai_test.map.scen");
+    ofs << "version 1\n0\tm.map\t16\t16\t0\t0\n";
+  }
+  ASSERT_TRUE(fudge::load_moving_ai_scenarios("moving_ai_test.map.scen")
+              .empty());
+
+  std::remove("moving_ai_test.map");
+  std::remove("moving_ai_test.map.scen");
+}
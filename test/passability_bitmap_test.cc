@@ -0,0 +1,46 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "passability_bitmap.h"
+#include "vertex_matrix.h"
+#include "versioned_matrix.h"
+
+// Test if the bitmap agrees with the matrix, and the border is impassable.
+TEST(PassabilityBitmap, from_matrix) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+  fudge::VertexMatrix<double> vertex_matrix(10, 10, matrix);
+  fudge::PassabilityBitmap bitmap(vertex_matrix);
+  fudge::PassabilityBitmap unweighted(vertex_matrix, 1.0);
+
+  for (int y = -1; y <= 10; y++) {
+    for (int x = -1; x <= 10; x++) {
+      fudge::Coord c(x, y);
+      ASSERT_EQ(vertex_matrix.is_passable(c), bitmap.is_passable(c));
+      ASSERT_EQ(vertex_matrix.is_passable(c, 1.0), unweighted.is_passable(c));
+    }
+  }
+  ASSERT_EQ(24u, bitmap.memory_usage());
+}
+
+// Test if snapshots carry a bitmap in sync with their weights.
+TEST(PassabilityBitmap, versioned_matrix) {
+  fudge::VersionedMatrix<int> matrix(4, 4, std::vector<int>(16, 1));
+  fudge::VertexMatrix<int> s0 = matrix.snapshot();
+  matrix.apply_updates({{fudge::Coord(1, 1), -1}, {fudge::Coord(3, 3), 2}});
+  fudge::VertexMatrix<int> s1 = matrix.snapshot();
+
+  ASSERT_TRUE(s0.passability()->is_passable(fudge::Coord(1, 1)));
+  ASSERT_FALSE(s1.passability()->is_passable(fudge::Coord(1, 1)));
+  ASSERT_TRUE(s1.passability()->is_passable(fudge::Coord(3, 3)));
+  ASSERT_FALSE(s1.passability()->is_passable(fudge::Coord(4, 3)));
+  ASSERT_NE(s0.passability(), s1.passability());
+
+  // No snapshot shares the bitmap, so it's updated in place.
+  s1 = s0;
+  const fudge::PassabilityBitmap *p = matrix.snapshot().passability().get();
+  matrix.apply_updates({{fudge::Coord(1, 1), 1}});
+  ASSERT_EQ(p, matrix.snapshot().passability().get());
+  ASSERT_TRUE(matrix.snapshot().passability()->is_passable(
+      fudge::Coord(1, 1)));
+}
@@ -0,0 +1,84 @@
+#include <vector>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "astar_search.h"
+#include "grid_map.h"
+#include "path_database.h"
+
+// Sum edge costs of a path in the order returned by get_path().
+double path_cost(const fudge::VertexMatrix<double> &vertex_matrix,
+                 const fudge::Coord &start,
+                 const std::vector<fudge::Coord> &path) {
+  double cost = 0;
+  fudge::Coord c = start;
+  for (auto i = path.rbegin(); i != path.rend(); ++i) {
+    bool diagonal = i->first != c.first && i->second != c.second;
+    cost += vertex_matrix.weight(*i) * (diagonal
+        ? fudge::GridMap<double>::kDiagonalEdgeWeight
+        : fudge::GridMap<double>::kStraightEdgeWeight);
+    c = *i;
+  }
+  return cost;
+}
+
+// Test if paths extracted match the costs found by A* search.
+TEST(CompressedPathDatabase, path_100x100) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_100x100.txt");
+
+  // Only a corner of the map to keep the test fast.
+  std::vector<double> corner;
+  for (int y = 0; y < 24; y++)
+    for (int x = 0; x < 24; x++)
+      corner.push_back(matrix[y * 100 + x]);
+  fudge::VertexMatrix<double> vertex_matrix(24, 24, corner);
+
+  fudge::CompressedPathDatabase<double> cpd;
+  cpd.build(vertex_matrix, true, 2);
+  ASSERT_LT(cpd.runs(), 24u * 24 * 24 * 24 / 4);
+
+  for (int i = 0; i < 24 * 24; i += 29) {
+    for (int j = 0; j < 24 * 24; j += 17) {
+      fudge::Coord start(i % 24, i / 24);
+      fudge::Coord goal(j % 24, j / 24);
+      if (!vertex_matrix.is_passable(start)
+          || !vertex_matrix.is_passable(goal) || start == goal)
+        continue;
+
+      fudge::GridMap<double> map(24, 24, corner);
+      fudge::astar_search(map, start, goal,
+                          fudge::GridMap<double>::diagonal_distance);
+
+      const std::vector<fudge::Coord> path = cpd.path(start, goal);
+      ASSERT_EQ(goal, path.front());
+      ASSERT_NEAR(map.node(goal)->g_,
+                  path_cost(vertex_matrix, start, path), 0.001);
+    }
+  }
+}
+
+TEST(CompressedPathDatabase, save_load) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_10x10_wall.txt");
+
+  fudge::CompressedPathDatabase<double> cpd;
+  cpd.build(fudge::VertexMatrix<double>(10, 10, matrix));
+  ASSERT_TRUE(cpd.save("path_database.bin"));
+
+  fudge::CompressedPathDatabase<double> loaded;
+  ASSERT_TRUE(loaded.load("path_database.bin"));
+  std::remove("path_database.bin");
+
+  ASSERT_EQ(cpd.runs(), loaded.runs());
+  for (int i = 0; i < 100; i++)
+    for (int j = 0; j < 100; j++)
+      ASSERT_EQ(cpd.path(fudge::Coord(i % 10, i / 10),
+                         fudge::Coord(j % 10, j / 10)),
+                loaded.path(fudge::Coord(i % 10, i / 10),
+                            fudge::Coord(j % 10, j / 10)));
+
+  // Walls and unreachable nodes.
+  ASSERT_EQ(0, loaded.path(fudge::Coord(0, 0), fudge::Coord(5, 0)).size());
+  ASSERT_FALSE(loaded.load("../data/matrix_10x10_wall.txt"));
+}
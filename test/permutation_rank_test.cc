@@ -0,0 +1,33 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "permutation_rank.h"
+#include "ranked_map.h"
+
+// Test if ranks of all permutations of 8 elements are distinct and dense.
+TEST(PermutationRank, rank_unrank_8) {
+  const int n = 8;
+  std::vector<bool> seen(fudge::factorial(n), false);
+  for (uint64_t r = 0; r < fudge::factorial(n); r++) {
+    const uint64_t packed = fudge::permutation_unrank(r, n);
+    ASSERT_EQ(r, fudge::permutation_rank(packed, n));
+    ASSERT_FALSE(seen[r]);
+    seen[r] = true;
+  }
+
+  ASSERT_EQ(0u, fudge::permutation_rank(0x76543210, n));
+  ASSERT_EQ(fudge::factorial(n) - 1,
+            fudge::permutation_rank(0x01234567, n));
+}
+
+TEST(PermutationRank, ranked_map) {
+  fudge::RankedMap<uint64_t, int, fudge::PackedPermutationRank<3>> map;
+  map[0x012] = 1;
+  map[0x210] = 2;
+  map[0x012] += 10;
+
+  ASSERT_EQ(2u, map.size());
+  ASSERT_EQ(11, map.at(0x012));
+  ASSERT_EQ(1u, map.count(0x210));
+  ASSERT_EQ(0u, map.count(0x102));
+  ASSERT_THROW(map.at(0x102), std::out_of_range);
+}
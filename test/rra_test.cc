@@ -22,3 +22,59 @@ TEST(RRA, search) {
                      fudge::GridMap<int>::manhattan_distance);
   ASSERT_EQ(4, c);
 }
+
+TEST(RRA, search_budget) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_10x10_plain.txt");
+
+  // Room for a single table only.
+  fudge::RRA<int> rra(matrix, 10, 10, 1);
+  ASSERT_EQ(10, rra.search(fudge::Coord(0, 0), fudge::Coord(5, 5),
+                           fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(4, rra.search(fudge::Coord(0, 0), fudge::Coord(2, 2),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(2, rra.stats_.hits + rra.stats_.misses);
+
+  ASSERT_EQ(18, rra.search(fudge::Coord(9, 9), fudge::Coord(0, 0),
+                           fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(1, rra.stats_.evictions);
+  ASSERT_EQ(1, rra.stats_.entries);
+
+  ASSERT_EQ(10, rra.search(fudge::Coord(0, 0), fudge::Coord(5, 5),
+                           fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(2, rra.stats_.evictions);
+  ASSERT_EQ(1, rra.stats_.entries);
+}
+
+// Test if the search resumes from the saved open list.
+TEST(RRA, search_resume) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_10x10_wall.txt");
+
+  fudge::RRA<int> rra(matrix, 10, 10);
+  int a = rra.search(fudge::Coord(9, 9), fudge::Coord(0, 0),
+                     fudge::GridMap<int>::manhattan_distance);
+  int closed = rra.search_stats_.nodes_closed;
+
+  // Nodes closed by the first search are answered without any expansion.
+  int b = rra.search(fudge::Coord(9, 9), fudge::Coord(9, 8),
+                     fudge::GridMap<int>::manhattan_distance);
+  ASSERT_EQ(1, b);
+  ASSERT_EQ(closed, rra.search_stats_.nodes_closed);
+
+  // Query all cells. Each node is closed only once.
+  fudge::GridMap<int> map(10, 10, matrix, false);
+  for (int y = 0; y < 10; y++) {
+    for (int x = 0; x < 10; x++) {
+      fudge::Coord c(x, y);
+      int d = rra.search(fudge::Coord(9, 9), c,
+                         fudge::GridMap<int>::manhattan_distance);
+      if (!map.vertex_matrix_.is_passable(c)) {
+        ASSERT_EQ(-1, d);
+      } else if (c == fudge::Coord(0, 0)) {
+        ASSERT_EQ(a, d);
+      }
+    }
+  }
+  ASSERT_GE(100, rra.search_stats_.nodes_closed);
+}
@@ -0,0 +1,86 @@
+#include <vector>
+#include <thread>
+#include <functional>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "astar_search.h"
+#include "shared_rra.h"
+#include "multi_agent_map.h"
+
+// Test if concurrent searches agree with a single threaded RRA.
+TEST(SharedRRA, search_concurrent) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_10x10_wall.txt");
+
+  fudge::RRA<int> rra(matrix, 10, 10);
+  fudge::SharedRRA<int> shared_rra(matrix, 10, 10);
+
+  std::vector<std::vector<int>> results(4, std::vector<int>(100 * 4));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([t, &shared_rra, &results]() {
+      // Each thread queries the cells in a different order.
+      for (int k = 0; k < 100 * 4; k++) {
+        int i = (k * 37 + t * 11) % 400;
+        fudge::Coord start((i / 100) * 9 % 10, (i / 100) / 2 * 9);
+        fudge::Coord end(i % 100 % 10, i % 100 / 10);
+        results[t][i] = shared_rra.search(start, end,
+            fudge::GridMap<int>::manhattan_distance);
+      }
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  int queries = 0;
+  for (int i = 0; i < 400; i++) {
+    fudge::Coord start((i / 100) * 9 % 10, (i / 100) / 2 * 9);
+    fudge::Coord end(i % 100 % 10, i % 100 / 10);
+    int expected = rra.search(start, end,
+                              fudge::GridMap<int>::manhattan_distance);
+    for (int t = 0; t < 4; t++)
+      ASSERT_EQ(expected, results[t][i]);
+    if (matrix[end.second * 10 + end.first] >= 0)
+      queries += 4;
+  }
+
+  fudge::CacheStats stats = shared_rra.stats();
+  ASSERT_EQ(4, stats.entries);
+  ASSERT_EQ(queries, stats.hits + stats.misses);
+}
+
+// Test 2 maps solving in parallel with shared RRA* costs.
+TEST(SharedRRA, multi_agent_map_parallel) {
+  std::vector<int> matrix = fudge::load_matrix<int>(
+      "../data/matrix_10x10_agents.txt");
+  auto shared_rra = std::make_shared<fudge::SharedRRA<int>>(matrix, 10, 10);
+
+  std::vector<std::size_t> sizes(2);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; t++) {
+    threads.push_back(std::thread([t, &matrix, &shared_rra, &sizes]() {
+      MultiAgentMap map(10, 10, matrix, shared_rra);
+      auto start = MultiAgentNode::create(
+          {},
+          {},
+          {Agent(0, Pos(0, 0), Pos(9, 9), 1),
+           Agent (1, Pos(0, 0), Pos(9, 9), 1)});
+      auto end = MultiAgentNode::create();
+      const std::vector<std::shared_ptr<MultiAgentNode>> path =
+          fudge::astar_search(map, start, end,
+              std::bind(&MultiAgentMap::heuristic_rra, &map,
+                        std::placeholders::_1, std::placeholders::_2));
+      std::size_t count = 1;
+      for (auto &n : path)
+        if (n->end_of_turn_)
+          ++count;
+      sizes[t] = count;
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  ASSERT_EQ(20, sizes[0]);
+  ASSERT_EQ(20, sizes[1]);
+  ASSERT_EQ(1, shared_rra->stats().entries);
+}
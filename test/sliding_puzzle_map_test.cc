@@ -1,6 +1,7 @@
 #include <functional>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 #include <gtest/gtest.h>
 #include "sliding_puzzle_map.h"
 #include "astar_search.h"
@@ -71,3 +72,145 @@ TEST(SlidingPuzzleMap, search_4x4_found) {
   ASSERT_EQ(7, path.size());
 }
 
+// Test if the flat hash table explores the same positions as std::map.
+TEST(SlidingPuzzleMap, search_3x3_ordered) {
+  PREPARE_TIMER
+  START_TIMER
+    OrderedSlidingPuzzleMap map0(3);
+    const std::vector<SlidingPosition> path0 = fudge::astar_search(map0,
+        SlidingPosition("876543210"), SlidingPosition("123456780"),
+        std::bind(&OrderedSlidingPuzzleMap::manhattan_distance, map0,
+            std::placeholders::_1, std::placeholders::_2));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  START_TIMER
+    SlidingPuzzleMap map1(3);
+    const std::vector<SlidingPosition> path1 = fudge::astar_search(map1,
+        SlidingPosition("876543210"), SlidingPosition("123456780"),
+        std::bind(&SlidingPuzzleMap::manhattan_distance, map1,
+            std::placeholders::_1, std::placeholders::_2));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_EQ(path0.size(), path1.size());
+  ASSERT_EQ(map0.stats_.to_string(), map1.stats_.to_string());
+  ASSERT_EQ(map0.map_.size(), map1.map_.size());
+}
+
+// Test moves of a packed position.
+TEST(SlidingPuzzleMap, packed_position) {
+  PackedSlidingPosition p("fedcba9876543210");
+  ASSERT_EQ(15, p.hole_);
+  ASSERT_EQ(0x0123456789abcdefULL, p.hash()); // Cell i in nibble i.
+  ASSERT_EQ("fedcba9876543210", p.to_string());
+
+  p.move(14);
+  ASSERT_EQ(14, p.hole_);
+  ASSERT_EQ("fedcba9876543201", p.to_string());
+  ASSERT_TRUE(p == PackedSlidingPosition("fedcba9876543201"));
+  ASSERT_FALSE(p == PackedSlidingPosition("fedcba9876543210"));
+}
+
+// Test if positions have no vtable, and packed ones are copied as bytes.
+TEST(SlidingPuzzleMap, static_position) {
+  ASSERT_FALSE(std::is_polymorphic<SlidingPosition>::value);
+  ASSERT_FALSE(std::is_polymorphic<PackedSlidingPosition>::value);
+  ASSERT_TRUE(std::is_trivially_copyable<PackedSlidingPosition>::value);
+
+  SlidingPosition p("123456780");
+  ASSERT_TRUE(p == SlidingPosition("123456780"));
+  ASSERT_FALSE(p == SlidingPosition("123456708"));
+}
+
+// Test if linear conflict takes out the fewest tiles of a line of 5, whose
+// goal columns are 1, 3, 0, 4, 2: 2 tiles, not the 3 of a greedy count.
+TEST(SlidingPuzzleMap, linear_conflict_5x2) {
+  const PackedSlidingPosition start("2415367890");
+  const PackedSlidingPosition goal("1234567890");
+  PackedSlidingPuzzleMap map(5, 2);
+  ASSERT_EQ(8, map.manhattan_distance(start, goal));
+  ASSERT_EQ(12, map.linear_conflict(start, goal));
+
+  const std::vector<PackedSlidingPosition> path = fudge::astar_search(map,
+      start, goal,
+      std::bind(&PackedSlidingPuzzleMap::manhattan_distance, &map,
+          std::placeholders::_1, std::placeholders::_2));
+  ASSERT_FALSE(path.empty());
+  for (std::size_t i = 0; i < path.size(); i++)
+    ASSERT_GE(static_cast<int>(i), map.linear_conflict(path[i], goal));
+}
+
+// Test if packed positions give the same search as strings.
+TEST(SlidingPuzzleMap, search_packed) {
+  PREPARE_TIMER
+  START_TIMER
+    PackedSlidingPuzzleMap map0(3);
+    const std::vector<PackedSlidingPosition> path0 = fudge::astar_search(map0,
+        PackedSlidingPosition("876543210"), PackedSlidingPosition("123456780"),
+        std::bind(&PackedSlidingPuzzleMap::manhattan_distance, &map0,
+            std::placeholders::_1, std::placeholders::_2));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  SlidingPuzzleMap map1(3);
+  const std::vector<SlidingPosition> path1 = fudge::astar_search(map1,
+      SlidingPosition("876543210"), SlidingPosition("123456780"),
+      std::bind(&SlidingPuzzleMap::manhattan_distance, map1,
+          std::placeholders::_1, std::placeholders::_2));
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_EQ(map1.stats_.nodes_closed, map0.stats_.nodes_closed);
+  for (std::size_t i = 0; i < path0.size(); i++)
+    ASSERT_EQ(path1[i].to_string(), path0[i].to_string());
+
+  PackedSlidingPuzzleMap map2(4);
+  const std::vector<PackedSlidingPosition> path2 = fudge::astar_search(map2,
+      PackedSlidingPosition("fedcba9876543210"),
+      PackedSlidingPosition("0fdcbea876953214"),
+      std::bind(&PackedSlidingPuzzleMap::manhattan_distance, &map2,
+          std::placeholders::_1, std::placeholders::_2));
+  ASSERT_EQ(7, path2.size());
+}
+
+// Test if positions indexed by rank give the same search as a hash table.
+TEST(SlidingPuzzleMap, search_ranked) {
+  PREPARE_TIMER
+  START_TIMER
+    RankedSlidingPuzzleMap<9> map0(3);
+    const std::vector<PackedSlidingPosition> path0 = fudge::astar_search(map0,
+        PackedSlidingPosition("876543210"), PackedSlidingPosition("123456780"),
+        std::bind(&RankedSlidingPuzzleMap<9>::manhattan_distance, &map0,
+            std::placeholders::_1, std::placeholders::_2));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  PackedSlidingPuzzleMap map1(3);
+  const std::vector<PackedSlidingPosition> path1 = fudge::astar_search(map1,
+      PackedSlidingPosition("876543210"), PackedSlidingPosition("123456780"),
+      std::bind(&PackedSlidingPuzzleMap::manhattan_distance, &map1,
+          std::placeholders::_1, std::placeholders::_2));
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_EQ(map1.stats_.to_string(), map0.stats_.to_string());
+  for (std::size_t i = 0; i < path0.size(); i++)
+    ASSERT_EQ(path1[i].to_string(), path0[i].to_string());
+
+  // The hardest 2x4 puzzle takes 36 moves.
+  RankedSlidingPuzzleMap<8> map2(4, 2);
+  const std::vector<PackedSlidingPosition> path2 = fudge::astar_search(map2,
+      PackedSlidingPosition("07214365"), PackedSlidingPosition("12345670"),
+      std::bind(&RankedSlidingPuzzleMap<8>::manhattan_distance, &map2,
+          std::placeholders::_1, std::placeholders::_2));
+  ASSERT_EQ(37, path2.size());
+
+  // An unsolvable one explores all the 8!/2 positions reachable.
+  RankedSlidingPuzzleMap<8> map3(4, 2);
+  const std::vector<PackedSlidingPosition> path3 = fudge::astar_search(map3,
+      PackedSlidingPosition("76543210"), PackedSlidingPosition("12345670"),
+      std::bind(&RankedSlidingPuzzleMap<8>::manhattan_distance, &map3,
+          std::placeholders::_1, std::placeholders::_2));
+  ASSERT_TRUE(path3.empty());
+  ASSERT_EQ(20160, map3.map_.size());
+}
@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <gtest/gtest.h>
+#include "sliding_puzzle_pdb.h"
+#include "astar_search.h"
+#include "util/time_util.h"
+
+typedef std::vector<std::shared_ptr<const SlidingPatternDatabase>> Pdbs;
+
+// Test if the heuristics find optimal paths with fewer expansions, and never
+// overestimate the moves left along the path.
+TEST(SlidingPatternDatabase, search_3x3) {
+  const PackedSlidingPosition goal("123456780");
+  Pdbs pdbs {
+      std::make_shared<SlidingPatternDatabase>(
+          3, 3, goal, std::vector<int>{1, 2, 3, 4}),
+      std::make_shared<SlidingPatternDatabase>(
+          3, 3, goal, std::vector<int>{5, 6, 7, 8})};
+  ASSERT_EQ(3024u, pdbs[0]->size());
+  const PatternDatabaseHeuristic heuristic(pdbs);
+
+  PackedSlidingPuzzleMap map0(3);
+  const std::vector<PackedSlidingPosition> path0 = fudge::astar_search(map0,
+      PackedSlidingPosition("876543210"), goal,
+      std::bind(&PackedSlidingPuzzleMap::manhattan_distance, &map0,
+          std::placeholders::_1, std::placeholders::_2));
+
+  PackedSlidingPuzzleMap map1(3);
+  const std::vector<PackedSlidingPosition> path1 = fudge::astar_search(map1,
+      PackedSlidingPosition("876543210"), goal,
+      std::bind(&PackedSlidingPuzzleMap::linear_conflict, &map1,
+          std::placeholders::_1, std::placeholders::_2));
+
+  PackedSlidingPuzzleMap map2(3);
+  const std::vector<PackedSlidingPosition> path2 = fudge::astar_search(map2,
+      PackedSlidingPosition("876543210"), goal, heuristic);
+
+  ASSERT_EQ(31, path0.size());
+  ASSERT_EQ(path0.size(), path1.size());
+  ASSERT_EQ(path0.size(), path2.size());
+  ASSERT_LT(map1.stats_.nodes_closed, map0.stats_.nodes_closed);
+  ASSERT_LT(map2.stats_.nodes_closed, map1.stats_.nodes_closed);
+
+  // The path is from the goal back to the start.
+  for (std::size_t i = 0; i < path2.size(); i++) {
+    ASSERT_GE(static_cast<int>(i), heuristic(path2[i], goal));
+    ASSERT_GE(static_cast<int>(i), map1.linear_conflict(path2[i], goal));
+  }
+}
+
+// Test if a saved database is loaded with the same values.
+TEST(SlidingPatternDatabase, save_load) {
+  const PackedSlidingPosition goal("123456780");
+  SlidingPatternDatabase pdb0(3, 3, goal, {1, 2, 3, 4});
+  const std::string filename = "sliding_puzzle_pdb_test.pdb";
+  ASSERT_TRUE(pdb0.save(filename));
+
+  SlidingPatternDatabase pdb1(filename);
+  ASSERT_TRUE(pdb1.is_open());
+  ASSERT_TRUE(pdb1.verify());
+  ASSERT_EQ(pdb0.size(), pdb1.size());
+  for (const char *p : {"876543210", "123456780", "012345678", "481357620"})
+    ASSERT_EQ(pdb0.lookup(PackedSlidingPosition(p)),
+              pdb1.lookup(PackedSlidingPosition(p)));
+  std::remove(filename.c_str());
+
+  SlidingPatternDatabase pdb2("not_found.pdb");
+  ASSERT_FALSE(pdb2.is_open());
+}
+
+// Test a 4x4 puzzle with additive 5-5-5 databases.
+TEST(SlidingPatternDatabase, search_4x4) {
+  const PackedSlidingPosition goal("123456789abcdef0");
+  Pdbs pdbs;
+  for (auto tiles : {std::vector<int>{1, 2, 3, 5, 6},
+                     std::vector<int>{4, 7, 8, 11, 12},
+                     std::vector<int>{9, 10, 13, 14, 15}})
+    pdbs.push_back(std::make_shared<SlidingPatternDatabase>(4, 4, goal, tiles));
+
+  PREPARE_TIMER
+  START_TIMER
+    PackedSlidingPuzzleMap map(4);
+    const std::vector<PackedSlidingPosition> path = fudge::astar_search(map,
+        PackedSlidingPosition("620bfec3d1475a98"), goal,
+        PatternDatabaseHeuristic(pdbs));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  ASSERT_EQ(47, path.size()); // 46 moves.
+}
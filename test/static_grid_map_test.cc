@@ -0,0 +1,49 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "static_grid_map.h"
+#include "astar_search.h"
+#include "load_matrix.h"
+
+// Test if the static map finds the same paths as GridMap, with and without
+// diagonal moves.
+TEST(StaticGridMap, search_100x100) {
+  std::vector<double> matrix = fudge::load_matrix<double>(
+      "../data/matrix_100x100.txt");
+
+  fudge::GridMap<double> map0(100, 100, matrix);
+  fudge::StaticGridMap<double, 100, 100> map1(matrix);
+  const std::vector<fudge::Coord> p0 = fudge::astar_search(
+      map0, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+  const std::vector<fudge::Coord> p1 = fudge::astar_search(
+      map1, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::diagonal_distance);
+
+  ASSERT_EQ(135, p1.size());
+  ASSERT_EQ(p0, p1);
+  ASSERT_EQ(map0.stats_.nodes_closed, map1.stats_.nodes_closed);
+  ASSERT_EQ(map0.to_string(), map1.to_string());
+
+  fudge::GridMap<double> map2(100, 100, matrix, false);
+  fudge::StaticGridMap<double, 100, 100, false> map3(matrix);
+  const std::vector<fudge::Coord> p2 = fudge::astar_search(
+      map2, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::manhattan_distance);
+  const std::vector<fudge::Coord> p3 = fudge::astar_search(
+      map3, fudge::Coord(0, 0), fudge::Coord(99, 99),
+      fudge::GridMap<double>::manhattan_distance);
+
+  ASSERT_FALSE(p3.empty());
+  ASSERT_EQ(p2, p3);
+  ASSERT_EQ(map2.stats_.nodes_closed, map3.stats_.nodes_closed);
+}
+
+// Test if the weights are used in place.
+TEST(StaticGridMap, row_major) {
+  std::vector<double> matrix(16, 1.0);
+  fudge::VertexMatrix<double, fudge::FixedRowMajorLayout<4, 4>>
+      vertex_matrix(4, 4, matrix);
+  ASSERT_EQ(matrix.data(), vertex_matrix.data());
+  typedef fudge::FixedRowMajorLayout<4, 4> Layout;
+  ASSERT_EQ(9u, Layout::index(fudge::Coord(1, 2)));
+}
@@ -52,3 +52,29 @@ TEST(TorchesPuzzle, search) {
   ASSERT_EQ(4, path.size());
   ASSERT_EQ(28, map.stats_.nodes_opened);
 }
+
+// Test if torches as bits give the same search.
+TEST(TorchesPuzzle, search_bits) {
+  const std::vector<Torch> torches {
+    {1, 6},
+    {2, 3},
+    {3, 4},
+    {4, 6},
+    {5, 3},
+    {6, 0},
+    {0, 1}};
+  TorchesPosition start(torches);
+  start.pos_[0].on_ = true;
+  start.pos_[1].on_ = true;
+  ASSERT_EQ(0x03, BitTorchesPosition(start).on_);
+  ASSERT_EQ("1100000", BitTorchesPosition(start).to_string());
+
+  BitTorchesPuzzle map(torches);
+  ASSERT_EQ(0x43, map.masks()[0]);
+  const std::vector<BitTorchesPosition> path = fudge::astar_search(
+      map, BitTorchesPosition(start), BitTorchesPosition(0x7f, 7),
+      std::bind(&BitTorchesPuzzle::heuristic, &map,
+                std::placeholders::_1, std::placeholders::_2));
+  ASSERT_EQ(4, path.size());
+  ASSERT_EQ(0x7f, path.front().on_);
+}
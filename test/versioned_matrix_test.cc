@@ -0,0 +1,115 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "load_matrix.h"
+#include "versioned_matrix.h"
+#include "rra.h"
+
+// Test if snapshots keep their weights after updates.
+TEST(VersionedMatrix, apply_updates) {
+  fudge::VersionedMatrix<int> matrix(10, 10,
+      fudge::load_matrix<int>("../data/matrix_10x10_plain.txt"));
+  ASSERT_EQ(0u, matrix.version());
+
+  fudge::VertexMatrix<int> s0 = matrix.snapshot();
+  ASSERT_TRUE(matrix.apply_updates({{fudge::Coord(1, 0), 5},
+                                    {fudge::Coord(3, 2), -1}}));
+  ASSERT_EQ(1u, matrix.version());
+  ASSERT_EQ(1, s0.weight(fudge::Coord(1, 0)));
+  ASSERT_EQ(5, matrix.weight(fudge::Coord(1, 0)));
+
+  fudge::VertexMatrix<int> s1 = matrix.snapshot();
+  ASSERT_EQ(1u, s1.version_);
+  ASSERT_EQ(5, s1.weight(fudge::Coord(1, 0)));
+  ASSERT_FALSE(s1.is_passable(fudge::Coord(3, 2)));
+  ASSERT_NE(s0.data(), s1.data());
+
+  // Nothing is updated if any cell is off the matrix.
+  ASSERT_FALSE(matrix.apply_updates({{fudge::Coord(0, 0), 2},
+                                     {fudge::Coord(10, 0), 2}}));
+  ASSERT_EQ(1u, matrix.version());
+  ASSERT_EQ(1, matrix.weight(fudge::Coord(0, 0)));
+
+  // A snapshot outlives the matrix.
+  fudge::VertexMatrix<int> s2 = matrix.snapshot();
+  {
+    fudge::VersionedMatrix<int> m(2, 2, {1, 2, 3, 4});
+    s2 = m.snapshot();
+  }
+  ASSERT_EQ(4, s2.weight(fudge::Coord(1, 1)));
+}
+
+TEST(VersionedMatrix, dirty_since) {
+  fudge::VersionedMatrix<int> matrix(10, 10, std::vector<int>(100, 1));
+  matrix.apply_updates({{fudge::Coord(1, 2), 2}});
+  matrix.apply_updates({{fudge::Coord(4, 3), 2}, {fudge::Coord(2, 5), 2}});
+
+  fudge::CellRegion r = matrix.dirty_since(0);
+  ASSERT_EQ(1, r.x0_);
+  ASSERT_EQ(2, r.y0_);
+  ASSERT_EQ(4, r.x1_);
+  ASSERT_EQ(5, r.y1_);
+
+  r = matrix.dirty_since(1);
+  ASSERT_EQ(2, r.x0_);
+  ASSERT_EQ(3, r.y0_);
+  ASSERT_TRUE(matrix.dirty_since(2).empty());
+
+  // Forgotten updates are reported as the whole matrix.
+  for (std::size_t i = 0; i < fudge::VersionedMatrix<int>::kHistorySize; i++)
+    matrix.apply_updates({{fudge::Coord(0, 0), 3}});
+  r = matrix.dirty_since(0);
+  ASSERT_EQ(0, r.x0_);
+  ASSERT_EQ(0, r.y0_);
+  ASSERT_EQ(9, r.x1_);
+  ASSERT_EQ(9, r.y1_);
+}
+
+// Test if RRA* drops only the tables affected by updates.
+TEST(VersionedMatrix, rra_sync) {
+  fudge::VersionedMatrix<int> matrix(10, 10,
+      fudge::load_matrix<int>("../data/matrix_10x10_plain.txt"));
+  fudge::RRA<int> rra(matrix.snapshot());
+
+  ASSERT_EQ(2, rra.search(fudge::Coord(0, 0), fudge::Coord(2, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(2, rra.search(fudge::Coord(9, 9), fudge::Coord(9, 7),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(2u, rra.stats_.entries);
+
+  matrix.apply_updates({{fudge::Coord(1, 0), 5}});
+  rra.sync(matrix);
+  ASSERT_EQ(1, rra.stats_.invalidations);
+  ASSERT_EQ(1u, rra.stats_.entries);
+
+  // The detour is cheaper than the updated node.
+  ASSERT_EQ(4, rra.search(fudge::Coord(0, 0), fudge::Coord(2, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(2, rra.search(fudge::Coord(9, 9), fudge::Coord(9, 7),
+                          fudge::GridMap<int>::manhattan_distance));
+
+  // Nothing changes without updates.
+  rra.sync(matrix);
+  ASSERT_EQ(1, rra.stats_.invalidations);
+}
+
+// Test if opening a wall drops the tables which explored cells next to it,
+// though the wall itself was never explored.
+TEST(VersionedMatrix, rra_sync_opened) {
+  fudge::VersionedMatrix<int> matrix(5, 3, {
+      1, 1, -1, 1, 1,
+      1, 1, -1, 1, 1,
+      1, 1,  1, 1, 1});
+  fudge::RRA<int> rra(matrix.snapshot());
+  ASSERT_EQ(8, rra.search(fudge::Coord(0, 0), fudge::Coord(4, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(7, rra.search(fudge::Coord(0, 0), fudge::Coord(3, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+
+  matrix.apply_updates({{fudge::Coord(2, 0), 1}});
+  rra.sync(matrix);
+  ASSERT_EQ(1, rra.stats_.invalidations);
+  ASSERT_EQ(4, rra.search(fudge::Coord(0, 0), fudge::Coord(4, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+  ASSERT_EQ(3, rra.search(fudge::Coord(0, 0), fudge::Coord(3, 0),
+                          fudge::GridMap<int>::manhattan_distance));
+}
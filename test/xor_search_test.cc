@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "xor_search.h"
+#include "util/time_util.h"
+#include "torches_puzzle.h"
+
+// Torch i controls torches i + 1 and 5i + 2.
+static std::vector<Torch> make_torches(int n) {
+  std::vector<Torch> torches;
+  for (int i = 0; i < n; i++)
+    torches.push_back(Torch {(i + 1) % n, (i * 5 + 2) % n});
+  return torches;
+}
+
+// Test if the path is made of moves given, from the goal back to the start.
+static void check_path(const fudge::XorSearch &search,
+                       const std::vector<uint64_t> &masks,
+                       uint64_t start, uint64_t goal) {
+  const std::vector<uint64_t> path = search.path();
+  ASSERT_EQ(search.moves().size() + 1, path.size());
+  ASSERT_EQ(goal, path.front());
+  ASSERT_EQ(start, path.back());
+  for (std::size_t i = 1; i < path.size(); i++) {
+    ASSERT_NE(masks.end(),
+              std::find(masks.begin(), masks.end(), path[i - 1] ^ path[i]));
+  }
+}
+
+TEST(XorSearch, search_7_torches) {
+  const BitTorchesPuzzle map({
+    {1, 6},
+    {2, 3},
+    {3, 4},
+    {4, 6},
+    {5, 3},
+    {6, 0},
+    {0, 1}});
+  fudge::XorSearch search(map.masks(), 7);
+  ASSERT_TRUE(search.search(0x03, 0x7f));
+  ASSERT_EQ(3, search.moves().size());
+  check_path(search, map.masks(), 0x03, 0x7f);
+}
+
+TEST(XorSearch, search_24_torches) {
+  PREPARE_TIMER
+  START_TIMER
+  const BitTorchesPuzzle map(make_torches(24));
+  uint64_t goal = 0;
+  for (int i = 0; i < 24; i += 2)
+    goal ^= map.masks()[i * 7 % 24];
+  fudge::XorSearch search(map.masks(), 24);
+  ASSERT_TRUE(search.search(0, goal));
+  END_TIMER
+  PRINT_TIME_ELAPSED
+
+  ASSERT_EQ(12, search.moves().size());
+  check_path(search, map.masks(), 0, goal);
+  ASSERT_LT(search.memory_usage(), (std::size_t(1) << 24) / 2);
+}
+
+TEST(XorSearch, search_not_found) {
+  fudge::XorSearch search0({0x3, 0x6}, 3);
+  ASSERT_FALSE(search0.search(0x0, 0x1));
+  ASSERT_EQ(0, search0.nodes_visited());
+
+  fudge::XorSearch search1({0x3}, fudge::XorSearch::kMaxBits + 1);
+  ASSERT_FALSE(search1.search(0x0, 0x3));
+
+  // A goal out of reach takes no memory for states.
+  const BitTorchesPuzzle map(make_torches(28));
+  fudge::XorSearch search2(map.masks(), 28);
+  ASSERT_FALSE(search2.search(0x0, 0x1));
+  ASSERT_EQ(0, search2.nodes_visited());
+  ASSERT_EQ(0, search2.memory_usage());
+}
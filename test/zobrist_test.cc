@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "zobrist.h"
+#include "water_jug_map.h"
+#include "multi_agent_map.h"
+
+TEST(ZobristHash, update) {
+  fudge::ZobristHash h0;
+  h0.toggle(0, 3);
+  h0.toggle(1, 5);
+
+  // Order of components doesn't matter.
+  fudge::ZobristHash h1;
+  h1.toggle(1, 5);
+  h1.toggle(0, 3);
+  ASSERT_EQ(h0, h1);
+
+  // Neither does the path to the values.
+  h1.update(0, 3, 4);
+  ASSERT_NE(h0, h1);
+  h1.update(1, 5, 2);
+  h1.update(0, 4, 3);
+  h1.update(1, 2, 5);
+  ASSERT_EQ(h0, h1);
+
+  h1.toggle(1, 5);
+  h1.toggle(0, 3);
+  ASSERT_EQ(0u, h1.value());
+  ASSERT_NE(fudge::zobrist_key(0, 1), fudge::zobrist_key(1, 0));
+}
+
+// Test if hashes of successors are updated to those of the positions.
+TEST(ZobristHash, water_jug) {
+  WaterJugMap map({21, 15, 8, 5});
+  const WaterJugPosition start({21, 0, 0, 0});
+  for (const auto &e0 : map.edges(start)) {
+    for (const auto &e1 : map.edges(e0.to_)) {
+      ASSERT_EQ(WaterJugPosition(e1.to_.pos()).hash(), e1.to_.hash());
+      ASSERT_EQ(21, e1.to_.pos()[0] + e1.to_.pos()[1] + e1.to_.pos()[2]
+                    + e1.to_.pos()[3]);
+    }
+  }
+  ASSERT_EQ(WaterJugPosition({0, 15, 1, 5}).hash(),
+            WaterJugPosition({0, 15, 1, 5}).hash());
+  ASSERT_NE(WaterJugPosition({0, 15, 1, 5}).key_.zobrist_,
+            WaterJugPosition({0, 15, 5, 1}).key_.zobrist_);
+}
+
+// Test if positions of the same hash are still explored apart.
+TEST(ZobristHash, water_jug_collision) {
+  WaterJugPosition p0({0, 15, 1, 5});
+  WaterJugPosition p1({0, 15, 5, 1});
+  p1.key_.zobrist_ = p0.key_.zobrist_;
+  ASSERT_EQ(p0.hash().zobrist_, p1.hash().zobrist_);
+  ASSERT_FALSE(p0 == p1);
+
+  WaterJugMap map({21, 15, 8, 5});
+  map.open_node(p0, 0, 0, p0);
+  ASSERT_FALSE(map.is_node_unexplored(p0));
+  ASSERT_TRUE(map.is_node_unexplored(p1));
+  map.open_node(p1, 0, 0, p1);
+  ASSERT_EQ(2, map.map_.size());
+  ASSERT_EQ(1, map.map_.at(p1.hash()).pos()[3]);
+  ASSERT_EQ(1, map.stats_.hash_collisions);
+}
+
+TEST(ZobristHash, multi_agent) {
+  std::vector<int> matrix {
+    1, 1, 1,
+    1, 1, 1,
+    1, 1, 1
+  };
+  MultiAgentMap map(3, 3, matrix);
+  auto start = MultiAgentNode::create(
+      {},
+      {},
+      {Agent(0, Pos(0, 0), Pos(2, 2), 1),
+       Agent(1, Pos(2, 0), Pos(0, 2), 1),
+       Agent(2, Pos(1, 1), Pos(2, 1), 1)});
+  auto end = MultiAgentNode::create();
+  map.open_node(start, 0, map.heuristic_manhattan(start, end), start);
+
+  // Expand a few levels and compare each hash with one made from scratch.
+  std::vector<std::shared_ptr<MultiAgentNode>> nodes {start};
+  for (int level = 0; level < 4; level++) {
+    std::vector<std::shared_ptr<MultiAgentNode>> next;
+    for (auto &n : nodes) {
+      for (const auto &e : map.edges(n)) {
+        const std::size_t h = e.to_->hash_;
+        ASSERT_EQ(e.to_->hash(), h);
+        next.push_back(e.to_);
+      }
+    }
+    nodes.swap(next);
+  }
+  ASSERT_FALSE(nodes.empty());
+}